@@ -9,19 +9,17 @@ CONFIG += c++11
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    fv1thread.cpp \
-    fv2thread.cpp \
-    lvthread.cpp \
     main.cpp \
     controller.cpp \
-    zmq_class.cpp
+    vehiclethread.cpp \
+    zmq_class.cpp \
+    ../../../src/zmq_wire.cpp
 
 HEADERS += \
     controller.h \
-    fv1thread.h \
-    fv2thread.h \
-    lvthread.h \
-    zmq_class.h
+    vehiclethread.h \
+    zmq_class.h \
+    ../../../include/zmq_wire/zmq_wire.hpp
 
 FORMS += \
     controller.ui
@@ -31,7 +29,8 @@ TRANSLATIONS += \
 CONFIG += lrelease
 CONFIG += embed_translations
 
-INCLUDEPATH += /usr/local/include/opencv4
+INCLUDEPATH += /usr/local/include/opencv4 \
+               ../../../include
 
 LIBS += `pkg-config --libs opencv4` \
         -lzmq
@@ -1,33 +1,25 @@
 #include "controller.h"
 #include "ui_controller.h"
 
-QMutex Controller::lv_mutex_;
-QMutex Controller::fv1_mutex_;
-QMutex Controller::fv2_mutex_;
-
-ZmqData Controller::lv_data_;
-ZmqData Controller::fv1_data_;
-ZmqData Controller::fv2_data_;
+QMutex Controller::vehicle_mutex_[VEHICLES];
+ZmqData Controller::vehicle_data_[VEHICLES];
 
 Controller::Controller(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::Controller), ZMQ_SOCKET_()
 {
     ui->setupUi(this);
-    lv_thread_ = new LVThread(this);
-    fv1_thread_ = new FV1Thread(this);
-    fv2_thread_ = new FV2Thread(this);
-    qRegisterMetaType<ZmqData>("ZmqData");
-    connect(lv_thread_, SIGNAL(request(ZmqData)), this, SLOT(requestData(ZmqData)), Qt::DirectConnection);
-    connect(lv_thread_, SIGNAL(setValue(ZmqData)),this,SLOT(updateData(ZmqData)), Qt::AutoConnection);
-    connect(fv1_thread_, SIGNAL(request(ZmqData)), this, SLOT(requestData(ZmqData)), Qt::DirectConnection);
-    connect(fv1_thread_, SIGNAL(setValue(ZmqData)),this,SLOT(updateData(ZmqData)), Qt::AutoConnection);
-    connect(fv2_thread_, SIGNAL(request(ZmqData)), this, SLOT(requestData(ZmqData)), Qt::DirectConnection);
-    connect(fv2_thread_, SIGNAL(setValue(ZmqData)),this,SLOT(updateData(ZmqData)), Qt::AutoConnection);
+    views_[0] = { ui->LVCurVel, ui->LVVelBar, ui->LVCurDist, ui->LVDistBar, ui->LV_MAP };
+    views_[1] = { ui->FV1CurVel, ui->FV1VelBar, ui->FV1CurDist, ui->FV1DistBar, ui->FV1_MAP };
+    views_[2] = { ui->FV2CurVel, ui->FV2VelBar, ui->FV2CurDist, ui->FV2DistBar, ui->FV2_MAP };
 
-    if (ZMQ_SOCKET_.req_flag0_) lv_thread_->start();
-    if (ZMQ_SOCKET_.req_flag1_) fv1_thread_->start();
-    if (ZMQ_SOCKET_.req_flag2_) fv2_thread_->start();
+    qRegisterMetaType<ZmqData>("ZmqData");
+    for (int i = 0; i < VEHICLES; i++) {
+        vehicle_thread_[i] = new VehicleThread(i, this);
+        connect(vehicle_thread_[i], SIGNAL(request(ZmqData)), this, SLOT(requestData(ZmqData)), Qt::DirectConnection);
+        connect(vehicle_thread_[i], SIGNAL(setValue(ZmqData)),this,SLOT(updateData(ZmqData)), Qt::AutoConnection);
+        if (ZMQ_SOCKET_.req_flag_[i]) vehicle_thread_[i]->start();
+    }
 
     gettimeofday(&startTime_, NULL);
 
@@ -131,14 +123,14 @@ void Controller::recordData(struct timeval *startTime){
     flag = true;
   }
   else{
-    lv_mutex_.lock();
+    vehicle_mutex_[0].lock();
     gettimeofday(&currentTime, NULL);
     time_ = ((currentTime.tv_sec - startTime->tv_sec)) + ((currentTime.tv_usec - startTime->tv_usec)/1000000.0);
     //sprintf(buf, "%.3e,%.3f,%.3f,%.3f,%.3f,%.3f,%d", time_, est_vel_, tar_vel_, cur_vel_, sat_vel_, fabs(cur_vel_ - hat_vel_), alpha_);
-    sprintf(buf, "%.3e,%.3f,%.3f", time_, req_time_, ZMQ_SOCKET_.req_recv0_->cur_dist);
+    sprintf(buf, "%.3e,%.3f,%.3f", time_, req_time_, ZMQ_SOCKET_.req_recv_[0]->cur_dist);
     write_file.open(file, std::ios::out | std::ios::app);
     write_file << buf << std::endl;
-    lv_mutex_.unlock();
+    vehicle_mutex_[0].unlock();
   }
   write_file.close();
 }
@@ -147,29 +139,17 @@ void Controller::requestData(ZmqData zmq_data)
 {
     ZmqData send_data = zmq_data;
     struct timeval startTime, endTime;
-
-    if (send_data.tar_index == 0){
-        lv_mutex_.lock();
-        gettimeofday(&startTime, NULL);
-        ZMQ_SOCKET_.requestZMQ(&send_data);
-        gettimeofday(&endTime, NULL);
-        req_time_ = ((endTime.tv_sec - startTime.tv_sec)* 1000.0) + ((endTime.tv_usec - startTime.tv_usec)/1000.0);
-        lv_data_ = *ZMQ_SOCKET_.req_recv0_;
-        lv_mutex_.unlock();
-        //recordData(&startTime_);
-    }
-    else if (send_data.tar_index == 1){
-        fv1_mutex_.lock();
-        ZMQ_SOCKET_.requestZMQ(&send_data);
-        fv1_data_ = *ZMQ_SOCKET_.req_recv1_;
-        fv1_mutex_.unlock();
-    }
-    else if (send_data.tar_index == 2){
-        fv2_mutex_.lock();
-        ZMQ_SOCKET_.requestZMQ(&send_data);
-        fv2_data_ = *ZMQ_SOCKET_.req_recv2_;
-        fv2_mutex_.unlock();
-    }
+    int i = send_data.tar_index;
+    if (i >= VEHICLES) return;
+
+    vehicle_mutex_[i].lock();
+    gettimeofday(&startTime, NULL);
+    ZMQ_SOCKET_.requestZMQ(&send_data);
+    gettimeofday(&endTime, NULL);
+    if (i == 0) req_time_ = ((endTime.tv_sec - startTime.tv_sec)* 1000.0) + ((endTime.tv_usec - startTime.tv_usec)/1000.0);
+    vehicle_data_[i] = *ZMQ_SOCKET_.req_recv_[i];
+    vehicle_mutex_[i].unlock();
+    //if (i == 0) recordData(&startTime_);
 }
 
 void Controller::updateData(ZmqData zmq_data)
@@ -181,56 +161,22 @@ void Controller::updateData(ZmqData zmq_data)
     vel = tmp.cur_vel*deci;
     dist = tmp.cur_dist*deci;
 
-    if(tmp.tar_index == 20){
-      if(tmp.src_index == 0)
-      {
-          ui->LVCurVel->setText(QString::number(vel/deci));
-          if(vel > MaxVel) {
-              vel = MaxVel;
-          }
-          ui->LVVelBar->setValue(vel);
-          ui->LVCurDist->setText(QString::number(dist/deci));
-          if(dist > MaxDist) {
-              dist = MaxDist;
-          }
-          ui->LVDistBar->setValue(dist);
-          cv::Mat frame;
-          display_Map(tmp).copyTo(frame);
-          ui->LV_MAP->setPixmap(QPixmap::fromImage(QImage(frame.data, frame.cols, frame.rows, frame.step, QImage::Format_RGB888)));
-      }
-      else if (tmp.src_index == 1)
-      {
-          ui->FV1CurVel->setText(QString::number(vel/deci));
-          if(vel > MaxVel) {
-            vel = MaxVel;
-          }
-          ui->FV1VelBar->setValue(vel);
-          ui->FV1CurDist->setText(QString::number(dist/deci));
-          if(dist > MaxDist) {
-            dist = MaxDist;
-          }
-          ui->FV1DistBar->setValue(dist);
-          cv::Mat frame;
-          display_Map(tmp).copyTo(frame);
-          ui->FV1_MAP->setPixmap(QPixmap::fromImage(QImage(frame.data, frame.cols, frame.rows, frame.step, QImage::Format_RGB888)));
-      }
-      else if (tmp.src_index == 2)
-      {
-          ui->FV2CurVel->setText(QString::number(vel/deci));
-          if(vel > MaxVel) {
-            vel = MaxVel;
-          }
-          ui->FV2VelBar->setValue(vel);
-          ui->FV2CurDist->setText(QString::number(dist/deci));
-          if(dist > MaxDist) {
-            dist = MaxDist;
-          }
-          ui->FV2DistBar->setValue(dist);
-          cv::Mat frame;
-          display_Map(tmp).copyTo(frame);
-          ui->FV2_MAP->setPixmap(QPixmap::fromImage(QImage(frame.data, frame.cols, frame.rows, frame.step, QImage::Format_RGB888)));
-      }
+    if(tmp.tar_index != 20 || tmp.src_index >= VEHICLES) return;
+    const VehicleView& view = views_[tmp.src_index];
+
+    view.cur_vel->setText(QString::number(vel/deci));
+    if(vel > MaxVel) {
+        vel = MaxVel;
     }
+    view.vel_bar->setValue(vel);
+    view.cur_dist->setText(QString::number(dist/deci));
+    if(dist > MaxDist) {
+        dist = MaxDist;
+    }
+    view.dist_bar->setValue(dist);
+    cv::Mat frame;
+    display_Map(tmp).copyTo(frame);
+    view.map->setPixmap(QPixmap::fromImage(QImage(frame.data, frame.cols, frame.rows, frame.step, QImage::Format_RGB888)));
 }
 
 cv::Mat Controller::display_Map(ZmqData value)
@@ -287,6 +233,10 @@ cv::Mat Controller::display_Map(ZmqData value)
 
     //cv::line(map_frame, cv::Point(width/2 - check_dist,124 + value.roi_dist*100/490),cv::Point(width/2 + check_dist,124+value.roi_dist*100/490), cv::Scalar(255,100,100),3);
 
+    if(value.qos_level > 0) {  // steering from degraded vision
+      cv::putText(map_frame, "QoS " + std::to_string(value.qos_level), cv::Point(10, 25), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0,165,255), 2);
+    }
+
     cv::Mat swap_frame;
     cv::cvtColor(map_frame, swap_frame, cv::COLOR_BGR2RGB);
     return swap_frame;
@@ -11,9 +11,10 @@
 #include <iostream>
 #include <string>
 
-#include "lvthread.h"
-#include "fv1thread.h"
-#include "fv2thread.h"
+#include "vehiclethread.h"
+
+class QLabel;
+class QProgressBar;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class Controller; }
@@ -28,13 +29,8 @@ public:
     ~Controller();
     void sendData(int value_vel, int value_dist, int to);
 
-    static QMutex lv_mutex_;
-    static QMutex fv1_mutex_;
-    static QMutex fv2_mutex_;
-
-    static ZmqData lv_data_;
-    static ZmqData fv1_data_;
-    static ZmqData fv2_data_;
+    static QMutex vehicle_mutex_[VEHICLES];
+    static ZmqData vehicle_data_[VEHICLES];  // newest reply of each STC
 
     static int cnt;
 
@@ -102,9 +98,17 @@ private:
     Ui::Controller *ui;
     ZMQ_CLASS ZMQ_SOCKET_;
     cv::Mat display_Map(ZmqData zmq_data);
-    LVThread* lv_thread_;
-    FV1Thread* fv1_thread_;
-    FV2Thread* fv2_thread_;
+    VehicleThread* vehicle_thread_[VEHICLES];
+
+    //one truck's panel in controller.ui
+    typedef struct VehicleView{
+        QLabel* cur_vel;
+        QProgressBar* vel_bar;
+        QLabel* cur_dist;
+        QProgressBar* dist_bar;
+        QLabel* map;
+    }VehicleView;
+    VehicleView views_[VEHICLES];
 
     struct timeval startTime_;
     double time_ = 0.0;
@@ -1,150 +0,0 @@
-/****************************************************************************
-** Meta object code from reading C++ file 'fv1thread.h'
-**
-** Created by: The Qt Meta Object Compiler version 67 (Qt 5.9.5)
-**
-** WARNING! All changes made in this file will be lost!
-*****************************************************************************/
-
-#include "fv1thread.h"
-#include <QtCore/qbytearray.h>
-#include <QtCore/qmetatype.h>
-#if !defined(Q_MOC_OUTPUT_REVISION)
-#error "The header file 'fv1thread.h' doesn't include <QObject>."
-#elif Q_MOC_OUTPUT_REVISION != 67
-#error "This file was generated using the moc from 5.9.5. It"
-#error "cannot be used with the include files from this version of Qt."
-#error "(The moc has changed too much.)"
-#endif
-
-QT_BEGIN_MOC_NAMESPACE
-QT_WARNING_PUSH
-QT_WARNING_DISABLE_DEPRECATED
-struct qt_meta_stringdata_FV1Thread_t {
-    QByteArrayData data[6];
-    char stringdata0[45];
-};
-#define QT_MOC_LITERAL(idx, ofs, len) \
-    Q_STATIC_BYTE_ARRAY_DATA_HEADER_INITIALIZER_WITH_OFFSET(len, \
-    qptrdiff(offsetof(qt_meta_stringdata_FV1Thread_t, stringdata0) + ofs \
-        - idx * sizeof(QByteArrayData)) \
-    )
-static const qt_meta_stringdata_FV1Thread_t qt_meta_stringdata_FV1Thread = {
-    {
-QT_MOC_LITERAL(0, 0, 9), // "FV1Thread"
-QT_MOC_LITERAL(1, 10, 8), // "setValue"
-QT_MOC_LITERAL(2, 19, 0), // ""
-QT_MOC_LITERAL(3, 20, 7), // "ZmqData"
-QT_MOC_LITERAL(4, 28, 8), // "zmq_data"
-QT_MOC_LITERAL(5, 37, 7) // "request"
-
-    },
-    "FV1Thread\0setValue\0\0ZmqData\0zmq_data\0"
-    "request"
-};
-#undef QT_MOC_LITERAL
-
-static const uint qt_meta_data_FV1Thread[] = {
-
- // content:
-       7,       // revision
-       0,       // classname
-       0,    0, // classinfo
-       2,   14, // methods
-       0,    0, // properties
-       0,    0, // enums/sets
-       0,    0, // constructors
-       0,       // flags
-       2,       // signalCount
-
- // signals: name, argc, parameters, tag, flags
-       1,    1,   24,    2, 0x06 /* Public */,
-       5,    1,   27,    2, 0x06 /* Public */,
-
- // signals: parameters
-    QMetaType::Void, 0x80000000 | 3,    4,
-    QMetaType::Void, 0x80000000 | 3,    4,
-
-       0        // eod
-};
-
-void FV1Thread::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
-{
-    if (_c == QMetaObject::InvokeMetaMethod) {
-        FV1Thread *_t = static_cast<FV1Thread *>(_o);
-        Q_UNUSED(_t)
-        switch (_id) {
-        case 0: _t->setValue((*reinterpret_cast< ZmqData(*)>(_a[1]))); break;
-        case 1: _t->request((*reinterpret_cast< ZmqData(*)>(_a[1]))); break;
-        default: ;
-        }
-    } else if (_c == QMetaObject::IndexOfMethod) {
-        int *result = reinterpret_cast<int *>(_a[0]);
-        {
-            typedef void (FV1Thread::*_t)(ZmqData );
-            if (*reinterpret_cast<_t *>(_a[1]) == static_cast<_t>(&FV1Thread::setValue)) {
-                *result = 0;
-                return;
-            }
-        }
-        {
-            typedef void (FV1Thread::*_t)(ZmqData );
-            if (*reinterpret_cast<_t *>(_a[1]) == static_cast<_t>(&FV1Thread::request)) {
-                *result = 1;
-                return;
-            }
-        }
-    }
-}
-
-const QMetaObject FV1Thread::staticMetaObject = {
-    { &QThread::staticMetaObject, qt_meta_stringdata_FV1Thread.data,
-      qt_meta_data_FV1Thread,  qt_static_metacall, nullptr, nullptr}
-};
-
-
-const QMetaObject *FV1Thread::metaObject() const
-{
-    return QObject::d_ptr->metaObject ? QObject::d_ptr->dynamicMetaObject() : &staticMetaObject;
-}
-
-void *FV1Thread::qt_metacast(const char *_clname)
-{
-    if (!_clname) return nullptr;
-    if (!strcmp(_clname, qt_meta_stringdata_FV1Thread.stringdata0))
-        return static_cast<void*>(this);
-    return QThread::qt_metacast(_clname);
-}
-
-int FV1Thread::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
-{
-    _id = QThread::qt_metacall(_c, _id, _a);
-    if (_id < 0)
-        return _id;
-    if (_c == QMetaObject::InvokeMetaMethod) {
-        if (_id < 2)
-            qt_static_metacall(this, _c, _id, _a);
-        _id -= 2;
-    } else if (_c == QMetaObject::RegisterMethodArgumentMetaType) {
-        if (_id < 2)
-            *reinterpret_cast<int*>(_a[0]) = -1;
-        _id -= 2;
-    }
-    return _id;
-}
-
-// SIGNAL 0
-void FV1Thread::setValue(ZmqData _t1)
-{
-    void *_a[] = { nullptr, const_cast<void*>(reinterpret_cast<const void*>(&_t1)) };
-    QMetaObject::activate(this, &staticMetaObject, 0, _a);
-}
-
-// SIGNAL 1
-void FV1Thread::request(ZmqData _t1)
-{
-    void *_a[] = { nullptr, const_cast<void*>(reinterpret_cast<const void*>(&_t1)) };
-    QMetaObject::activate(this, &staticMetaObject, 1, _a);
-}
-QT_WARNING_POP
-QT_END_MOC_NAMESPACE
@@ -0,0 +1,26 @@
+#include "vehiclethread.h"
+#include "controller.h"
+
+VehicleThread::VehicleThread(int index, QObject *parent) : QThread(parent), index_(index)
+{
+
+}
+
+void VehicleThread::run()
+{
+    ZmqData tmp;
+    while(1)
+    {
+        tmp.src_index = 255;
+        tmp.tar_index = index_;
+        emit request(tmp);
+
+        Controller::vehicle_mutex_[index_].lock();
+        tmp = Controller::vehicle_data_[index_];
+        Controller::vehicle_mutex_[index_].unlock();
+
+        emit setValue(tmp);
+
+        msleep(100);
+    }
+}
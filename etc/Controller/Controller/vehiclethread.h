@@ -0,0 +1,25 @@
+#ifndef VEHICLETHREAD_H
+#define VEHICLETHREAD_H
+
+#include <QThread>
+
+#include "zmq_class.h"
+
+class Controller;
+
+/* Polls one truck's STC every 100 ms, index 0 = LV, 1 = FV1, ... */
+class VehicleThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit VehicleThread(int index, QObject* parent = nullptr);
+
+private:
+    void run();
+    int index_;
+signals:
+    void setValue(ZmqData zmq_data);
+    void request(ZmqData zmq_data);
+};
+
+#endif // VEHICLETHREAD_H
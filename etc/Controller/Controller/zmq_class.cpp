@@ -16,13 +16,11 @@ ZMQ_CLASS::~ZMQ_CLASS()
 {
   std::cout << "Disconnected" << std::endl;
   controlDone_ = true;
-  req_socket0_.close();
-  req_socket1_.close();
-  req_socket2_.close();
-
-  delete req_recv0_;
-  delete req_recv1_;
-  delete req_recv2_;
+  for(int i = 0; i < VEHICLES; i++)
+  {
+    req_socket_[i].close();
+    delete req_recv_[i];
+  }
 
   context_.close();
 }
@@ -31,36 +29,21 @@ void ZMQ_CLASS::init()
 {
   controlDone_ = false;
 
-  /* Initialize zmq data */
-  req_recv0_ = new ZmqData;
-  req_recv1_ = new ZmqData;
-  req_recv2_ = new ZmqData;
-
-  /* Initialize Tcp client(Request) Socket */
-  if(req_flag0_)
-  {
-    req_socket0_ = zmq::socket_t(context_, ZMQ_REQ);
-    req_socket0_.connect(tcpreq_ip0_);
-    req_socket0_.setsockopt(ZMQ_RCVTIMEO, -1);  //timeout (infinite)
-    req_socket0_.setsockopt(ZMQ_LINGER, 0);
-  }
-
-  if(req_flag1_)
+  /* Initialize Tcp client(Request) Sockets, one per truck STC */
+  for(int i = 0; i < VEHICLES; i++)
   {
-    req_socket1_ = zmq::socket_t(context_, ZMQ_REQ);
-    req_socket1_.connect(tcpreq_ip1_);
-    req_socket1_.setsockopt(ZMQ_RCVTIMEO, -1);
-    req_socket1_.setsockopt(ZMQ_LINGER, 0);
-  }
-
-  if(req_flag2_)
-  {
-    req_socket2_ = zmq::socket_t(context_, ZMQ_REQ);
-    req_socket2_.connect(tcpreq_ip2_);
-    req_socket2_.setsockopt(ZMQ_RCVTIMEO, -1);
-    req_socket2_.setsockopt(ZMQ_LINGER, 0);
+    req_recv_[i] = new ZmqData;
+    if(req_flag_[i]) connectReq(i);
   }
+}
 
+/* A REQ stuck without its reply can not send again, it is replaced by a new one */
+void ZMQ_CLASS::connectReq(int i)
+{
+  req_socket_[i] = zmq::socket_t(context_, ZMQ_REQ);
+  req_socket_[i].setsockopt(ZMQ_RCVTIMEO, REQUEST_TIMEOUT);
+  req_socket_[i].setsockopt(ZMQ_LINGER, 0);
+  req_socket_[i].connect(tcpreq_ip_[i]);
 }
 
 std::string ZMQ_CLASS::getIPAddress(){
@@ -90,83 +73,52 @@ std::string ZMQ_CLASS::getIPAddress(){
 
 bool ZMQ_CLASS::readParameters()
 {
-  std::string tcp_ip_server, tcp_ip_client0, tcp_ip_client1, tcp_ip_client2, tcpreq_port0, tcpreq_port1, tcpreq_port2;
-  std::string udp_ip, udp_port;
+  std::string tcp_ip_client[VEHICLES], tcpreq_port[VEHICLES];
   interface_name_ = std::string("ens33");
 
-  tcp_ip_server = std::string("tcp://*");
-  tcp_ip_client0 = std::string("tcp://192.168.0.10");  //LV
-  tcp_ip_client1 = std::string("tcp://192.168.0.11");  //FV1
-  tcp_ip_client2 = std::string("tcp://192.168.0.12");  //FV2
+  tcp_ip_client[0] = std::string("tcp://192.168.0.10");  //LV
+  tcp_ip_client[1] = std::string("tcp://192.168.0.11");  //FV1
+  tcp_ip_client[2] = std::string("tcp://192.168.0.12");  //FV2
 
-  tcpreq_port0 = std::string("7777");  //for LV
-  tcpreq_port1 = std::string("8888");  //for FV1
-  tcpreq_port2 = std::string("9999");  //for FV2
+  tcpreq_port[0] = std::string("7777");  //for LV
+  tcpreq_port[1] = std::string("8888");  //for FV1
+  tcpreq_port[2] = std::string("9999");  //for FV2
 
   zipcode_ = std::string("00020");
   
-  req_flag0_ = true;
-  req_flag1_ = true;
-  req_flag2_ = true;
-
-  //set reply socket ip
-  tcpreq_ip0_ = tcp_ip_client0;
-  tcpreq_ip0_.append(":");
-  tcpreq_ip0_.append(tcpreq_port0);
-
-  tcpreq_ip1_ = tcp_ip_client1;
-  tcpreq_ip1_.append(":");
-  tcpreq_ip1_.append(tcpreq_port1);
-
-  tcpreq_ip2_ = tcp_ip_client2;
-  tcpreq_ip2_.append(":");
-  tcpreq_ip2_.append(tcpreq_port2);
+  //set request socket ip
+  for(int i = 0; i < VEHICLES; i++)
+  {
+    req_flag_[i] = true;
+    tcpreq_ip_[i] = tcp_ip_client[i];
+    tcpreq_ip_[i].append(":");
+    tcpreq_ip_[i].append(tcpreq_port[i]);
+  }
 
   return true;
 }
 
 void* ZMQ_CLASS::requestZMQ(ZmqData* send_data)  // client: send -> recv
 { 
-  if(send_data->tar_index == 0){
-    if(req_socket0_.connected() && !controlDone_)
-    {
-      zmq::message_t recv_msg(DATASIZE), send_msg(DATASIZE);
-      //send
-      memcpy(send_msg.data(), send_data, DATASIZE);
-      req_socket0_.send(send_msg);
-
-      //recv
-      req_socket0_.recv(&recv_msg, 0);
-      memcpy(req_recv0_, recv_msg.data(), DATASIZE);
-//      req_recv0_ = static_cast<ZmqData *>(rep_msg.data());
-    }
-  }
-  if(send_data->tar_index == 1){
-    if(req_socket1_.connected() && !controlDone_)
-    {
-      zmq::message_t recv_msg(DATASIZE), send_msg(DATASIZE);
-      //send
-      memcpy(send_msg.data(), send_data, DATASIZE);
-      req_socket1_.send(send_msg);
-
-      //recv
-      req_socket1_.recv(&recv_msg, 0);
-      memcpy(req_recv1_, recv_msg.data(), DATASIZE);
-//      req_recv1_ = static_cast<ZmqData *>(rep_msg.data());
-    }
-  }
-  if(send_data->tar_index == 2){
-    if(req_socket2_.connected() && !controlDone_)
+  int i = send_data->tar_index;
+  if(i < VEHICLES && req_socket_[i].connected() && !controlDone_)
+  {
+    uint8_t buf[ZmqWire::MAX_SIZE];
+    gettimeofday(&send_data->send_stamp, NULL);
+    size_t size = ZmqWire::encode(*send_data, ZmqWire::MSG_TELEMETRY, req_seq_++, buf);
+    zmq::message_t recv_msg, send_msg(buf, size);
+    //send
+    req_socket_[i].send(send_msg);
+
+    //recv, req_recv_ keeps the last good packet
+    if(!req_socket_[i].recv(&recv_msg, 0))
     {
-      zmq::message_t recv_msg(DATASIZE), send_msg(DATASIZE);
-      //send
-      memcpy(send_msg.data(), send_data, DATASIZE);
-      req_socket2_.send(send_msg);
-
-      //recv
-      req_socket2_.recv(&recv_msg, 0);
-      memcpy(req_recv2_, recv_msg.data(), DATASIZE);
-//      req_recv2_ = static_cast<ZmqData *>(rep_msg.data());
+      req_timeouts_++;  //truck not answering, its thread polls again with a fresh socket
+      req_socket_[i].close();
+      connectReq(i);
+      return nullptr;
     }
+    if(!ZmqWire::decode(recv_msg.data(), recv_msg.size(), req_recv_[i])) wire_errors_++;
   }
+  return nullptr;
 }
@@ -17,58 +17,14 @@
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <atomic>
 
 #include <zmq.hpp>
 
-#define DATASIZE 84
+#include "zmq_wire/zmq_wire.hpp"
 
-typedef struct LaneCoef{
-	float a = 0.0f;
-	float b = 0.0f;
-	float c = 0.0f;
-}LaneCoef;
-
-typedef struct ImgData{
-        uint8_t src_index = 255;
-        uint8_t tar_index = 255;
-
-        struct timeval startTime;
-
-        u_char comp_image[100000] = {0,};
-        size_t size = 0;
-}ImgData;
-
-typedef struct ZmqData{
-        //Control center = 20, CRC = 30, LRC = 10, 11, 12, LV = 0, FV1 = 1, FV2 = 2
-        uint8_t src_index = 255;
-        uint8_t tar_index = 255;
-
-        //sensor failure
-        bool fi_encoder = false;
-        bool fi_camera = false;
-        bool fi_lidar = false;
-        bool alpha = false;
-        bool beta = false;
-        bool gamma = false;
-
-        //flag to send rear camera sensor image
-        bool send_rear_camera_image = false;
-
-        float ref_vel = 0.0f;
-        float cur_vel = 0.0f;
-        float cur_dist = 0.0f;
-        float cur_angle = 0.0f;
-        float tar_vel = 0.0f;
-        float tar_dist = 0.0f;
-        float est_vel = 0.0f;  //estimated velocity
-	float preceding_truck_vel = 0.0f;
-
-        //TM = 0, RCM = 1, GDM = 2
-        uint8_t lrc_mode = 0;
-        uint8_t crc_mode = 0;
-
-        LaneCoef coef[3];
-}ZmqData;
+#define VEHICLES 3  // trucks with a panel in controller.ui, LV = 0, FV1 = 1, FV2 = 2
+#define REQUEST_TIMEOUT 150  // milliseconds, a REQ without reply is reset after this
 
 class ZMQ_CLASS{
 public:
@@ -79,19 +35,24 @@ public:
   std::string getIPAddress();
 
   std::string zipcode_;
-  std::string tcpreq_ip0_, tcpreq_ip1_, tcpreq_ip2_;
+  std::string tcpreq_ip_[VEHICLES];
 
 
   bool controlDone_;
-  bool req_flag0_, req_flag1_, req_flag2_;
-  ZmqData *req_recv0_, *req_recv1_, *req_recv2_;
-  
+  bool req_flag_[VEHICLES];
+  ZmqData *req_recv_[VEHICLES];
+  //shared by the VehicleThreads, each truck's socket is only used under its vehicle_mutex_
+  std::atomic<uint32_t> req_seq_{0};
+  std::atomic<uint32_t> wire_errors_{0};  // replies dropped by ZmqWire::decode
+  std::atomic<uint32_t> req_timeouts_{0};  // REQ sockets reset after REQUEST_TIMEOUT
+
 private:
   void init();
   bool readParameters();
+  void connectReq(int i);
   
   std::string interface_name_;
-  zmq::socket_t req_socket0_, req_socket1_, req_socket2_;
+  zmq::socket_t req_socket_[VEHICLES];
   zmq::context_t context_;
 };
 
@@ -1,213 +0,0 @@
-/****************************************************************************
-** Meta object code from reading C++ file 'controller.h'
-**
-** Created by: The Qt Meta Object Compiler version 67 (Qt 5.9.5)
-**
-** WARNING! All changes made in this file will be lost!
-*****************************************************************************/
-
-#include "../Controller/controller.h"
-#include <QtCore/qbytearray.h>
-#include <QtCore/qmetatype.h>
-#if !defined(Q_MOC_OUTPUT_REVISION)
-#error "The header file 'controller.h' doesn't include <QObject>."
-#elif Q_MOC_OUTPUT_REVISION != 67
-#error "This file was generated using the moc from 5.9.5. It"
-#error "cannot be used with the include files from this version of Qt."
-#error "(The moc has changed too much.)"
-#endif
-
-QT_BEGIN_MOC_NAMESPACE
-QT_WARNING_PUSH
-QT_WARNING_DISABLE_DEPRECATED
-struct qt_meta_stringdata_Controller_t {
-    QByteArrayData data[28];
-    char stringdata0[531];
-};
-#define QT_MOC_LITERAL(idx, ofs, len) \
-    Q_STATIC_BYTE_ARRAY_DATA_HEADER_INITIALIZER_WITH_OFFSET(len, \
-    qptrdiff(offsetof(qt_meta_stringdata_Controller_t, stringdata0) + ofs \
-        - idx * sizeof(QByteArrayData)) \
-    )
-static const qt_meta_stringdata_Controller_t qt_meta_stringdata_Controller = {
-    {
-QT_MOC_LITERAL(0, 0, 10), // "Controller"
-QT_MOC_LITERAL(1, 11, 10), // "updateData"
-QT_MOC_LITERAL(2, 22, 0), // ""
-QT_MOC_LITERAL(3, 23, 7), // "ZmqData"
-QT_MOC_LITERAL(4, 31, 8), // "zmq_data"
-QT_MOC_LITERAL(5, 40, 26), // "on_MVelSlider_valueChanged"
-QT_MOC_LITERAL(6, 67, 5), // "value"
-QT_MOC_LITERAL(7, 73, 27), // "on_MDistSlider_valueChanged"
-QT_MOC_LITERAL(8, 101, 27), // "on_LVVelSlider_valueChanged"
-QT_MOC_LITERAL(9, 129, 28), // "on_LVDistSlider_valueChanged"
-QT_MOC_LITERAL(10, 158, 28), // "on_FV1VelSlider_valueChanged"
-QT_MOC_LITERAL(11, 187, 29), // "on_FV1DistSlider_valueChanged"
-QT_MOC_LITERAL(12, 217, 28), // "on_FV2VelSlider_valueChanged"
-QT_MOC_LITERAL(13, 246, 29), // "on_FV2DistSlider_valueChanged"
-QT_MOC_LITERAL(14, 276, 21), // "on_pushButton_clicked"
-QT_MOC_LITERAL(15, 298, 18), // "on_LVBox_activated"
-QT_MOC_LITERAL(16, 317, 5), // "index"
-QT_MOC_LITERAL(17, 323, 19), // "on_FV1Box_activated"
-QT_MOC_LITERAL(18, 343, 19), // "on_FV2Box_activated"
-QT_MOC_LITERAL(19, 363, 15), // "on_Send_clicked"
-QT_MOC_LITERAL(20, 379, 20), // "on_FV1_alpha_toggled"
-QT_MOC_LITERAL(21, 400, 7), // "checked"
-QT_MOC_LITERAL(22, 408, 19), // "on_FV1_beta_toggled"
-QT_MOC_LITERAL(23, 428, 20), // "on_FV1_gamma_toggled"
-QT_MOC_LITERAL(24, 449, 20), // "on_FV2_alpha_toggled"
-QT_MOC_LITERAL(25, 470, 19), // "on_FV2_beta_toggled"
-QT_MOC_LITERAL(26, 490, 20), // "on_FV2_gamma_toggled"
-QT_MOC_LITERAL(27, 511, 19) // "on_LV_alpha_toggled"
-
-    },
-    "Controller\0updateData\0\0ZmqData\0zmq_data\0"
-    "on_MVelSlider_valueChanged\0value\0"
-    "on_MDistSlider_valueChanged\0"
-    "on_LVVelSlider_valueChanged\0"
-    "on_LVDistSlider_valueChanged\0"
-    "on_FV1VelSlider_valueChanged\0"
-    "on_FV1DistSlider_valueChanged\0"
-    "on_FV2VelSlider_valueChanged\0"
-    "on_FV2DistSlider_valueChanged\0"
-    "on_pushButton_clicked\0on_LVBox_activated\0"
-    "index\0on_FV1Box_activated\0on_FV2Box_activated\0"
-    "on_Send_clicked\0on_FV1_alpha_toggled\0"
-    "checked\0on_FV1_beta_toggled\0"
-    "on_FV1_gamma_toggled\0on_FV2_alpha_toggled\0"
-    "on_FV2_beta_toggled\0on_FV2_gamma_toggled\0"
-    "on_LV_alpha_toggled"
-};
-#undef QT_MOC_LITERAL
-
-static const uint qt_meta_data_Controller[] = {
-
- // content:
-       7,       // revision
-       0,       // classname
-       0,    0, // classinfo
-      21,   14, // methods
-       0,    0, // properties
-       0,    0, // enums/sets
-       0,    0, // constructors
-       0,       // flags
-       0,       // signalCount
-
- // slots: name, argc, parameters, tag, flags
-       1,    1,  119,    2, 0x08 /* Private */,
-       5,    1,  122,    2, 0x08 /* Private */,
-       7,    1,  125,    2, 0x08 /* Private */,
-       8,    1,  128,    2, 0x08 /* Private */,
-       9,    1,  131,    2, 0x08 /* Private */,
-      10,    1,  134,    2, 0x08 /* Private */,
-      11,    1,  137,    2, 0x08 /* Private */,
-      12,    1,  140,    2, 0x08 /* Private */,
-      13,    1,  143,    2, 0x08 /* Private */,
-      14,    0,  146,    2, 0x08 /* Private */,
-      15,    1,  147,    2, 0x08 /* Private */,
-      17,    1,  150,    2, 0x08 /* Private */,
-      18,    1,  153,    2, 0x08 /* Private */,
-      19,    0,  156,    2, 0x08 /* Private */,
-      20,    1,  157,    2, 0x08 /* Private */,
-      22,    1,  160,    2, 0x08 /* Private */,
-      23,    1,  163,    2, 0x08 /* Private */,
-      24,    1,  166,    2, 0x08 /* Private */,
-      25,    1,  169,    2, 0x08 /* Private */,
-      26,    1,  172,    2, 0x08 /* Private */,
-      27,    1,  175,    2, 0x08 /* Private */,
-
- // slots: parameters
-    QMetaType::Void, 0x80000000 | 3,    4,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void, QMetaType::Int,    6,
-    QMetaType::Void,
-    QMetaType::Void, QMetaType::Int,   16,
-    QMetaType::Void, QMetaType::Int,   16,
-    QMetaType::Void, QMetaType::Int,   16,
-    QMetaType::Void,
-    QMetaType::Void, QMetaType::Bool,   21,
-    QMetaType::Void, QMetaType::Bool,   21,
-    QMetaType::Void, QMetaType::Bool,   21,
-    QMetaType::Void, QMetaType::Bool,   21,
-    QMetaType::Void, QMetaType::Bool,   21,
-    QMetaType::Void, QMetaType::Bool,   21,
-    QMetaType::Void, QMetaType::Bool,   21,
-
-       0        // eod
-};
-
-void Controller::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
-{
-    if (_c == QMetaObject::InvokeMetaMethod) {
-        Controller *_t = static_cast<Controller *>(_o);
-        Q_UNUSED(_t)
-        switch (_id) {
-        case 0: _t->updateData((*reinterpret_cast< ZmqData(*)>(_a[1]))); break;
-        case 1: _t->on_MVelSlider_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 2: _t->on_MDistSlider_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 3: _t->on_LVVelSlider_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 4: _t->on_LVDistSlider_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 5: _t->on_FV1VelSlider_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 6: _t->on_FV1DistSlider_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 7: _t->on_FV2VelSlider_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 8: _t->on_FV2DistSlider_valueChanged((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 9: _t->on_pushButton_clicked(); break;
-        case 10: _t->on_LVBox_activated((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 11: _t->on_FV1Box_activated((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 12: _t->on_FV2Box_activated((*reinterpret_cast< int(*)>(_a[1]))); break;
-        case 13: _t->on_Send_clicked(); break;
-        case 14: _t->on_FV1_alpha_toggled((*reinterpret_cast< bool(*)>(_a[1]))); break;
-        case 15: _t->on_FV1_beta_toggled((*reinterpret_cast< bool(*)>(_a[1]))); break;
-        case 16: _t->on_FV1_gamma_toggled((*reinterpret_cast< bool(*)>(_a[1]))); break;
-        case 17: _t->on_FV2_alpha_toggled((*reinterpret_cast< bool(*)>(_a[1]))); break;
-        case 18: _t->on_FV2_beta_toggled((*reinterpret_cast< bool(*)>(_a[1]))); break;
-        case 19: _t->on_FV2_gamma_toggled((*reinterpret_cast< bool(*)>(_a[1]))); break;
-        case 20: _t->on_LV_alpha_toggled((*reinterpret_cast< bool(*)>(_a[1]))); break;
-        default: ;
-        }
-    }
-}
-
-const QMetaObject Controller::staticMetaObject = {
-    { &QMainWindow::staticMetaObject, qt_meta_stringdata_Controller.data,
-      qt_meta_data_Controller,  qt_static_metacall, nullptr, nullptr}
-};
-
-
-const QMetaObject *Controller::metaObject() const
-{
-    return QObject::d_ptr->metaObject ? QObject::d_ptr->dynamicMetaObject() : &staticMetaObject;
-}
-
-void *Controller::qt_metacast(const char *_clname)
-{
-    if (!_clname) return nullptr;
-    if (!strcmp(_clname, qt_meta_stringdata_Controller.stringdata0))
-        return static_cast<void*>(this);
-    return QMainWindow::qt_metacast(_clname);
-}
-
-int Controller::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
-{
-    _id = QMainWindow::qt_metacall(_c, _id, _a);
-    if (_id < 0)
-        return _id;
-    if (_c == QMetaObject::InvokeMetaMethod) {
-        if (_id < 21)
-            qt_static_metacall(this, _c, _id, _a);
-        _id -= 21;
-    } else if (_c == QMetaObject::RegisterMethodArgumentMetaType) {
-        if (_id < 21)
-            *reinterpret_cast<int*>(_a[0]) = -1;
-        _id -= 21;
-    }
-    return _id;
-}
-QT_WARNING_POP
-QT_END_MOC_NAMESPACE
@@ -1,162 +1,127 @@
 #include "includes/crc.hpp"
 
 namespace CentralResiliencyCoordinator{
+
+static double ageMs(const struct timeval& stamp){
+  struct timeval now;
+  if(stamp.tv_sec == 0) return 0.0;
+  gettimeofday(&now, NULL);
+  return ((now.tv_sec - stamp.tv_sec) * 1000.0) + ((now.tv_usec - stamp.tv_usec) / 1000.0);
+}
   
-CentralRC::CentralRC()
-  : ZMQ_SOCKET_(){
+CentralRC::CentralRC(const std::vector<uint8_t>& platoon, const std::string& rep_endpoint)
+  : ZMQ_SOCKET_(rep_endpoint){
 
-  init();  
+  init(platoon);
 }
 
 CentralRC::~CentralRC(){
-  delete lv_data_;
-  delete fv1_data_;
-  delete fv2_data_;
 }
 
-void CentralRC::init(){
+void CentralRC::init(const std::vector<uint8_t>& platoon){
   is_node_running_ = true;
   index_ = 30;
   crc_mode_ = 0;
 
-  lv_data_ = new ZmqData;
-  fv1_data_ = new ZmqData;
-  fv2_data_ = new ZmqData;
-
-  lv_data_->src_index = index_;
-  lv_data_->tar_index = 10;
-
-  fv1_data_->src_index = index_;
-  fv1_data_->tar_index = 11;
-
-  fv2_data_->src_index = index_;
-  fv2_data_->tar_index = 12;
-
-  fv1_prev_dist_ = 0.8f;
-  fv2_prev_dist_ = 0.8f;
+  std::fill(std::begin(position_), std::end(position_), -1);
+  vehicles_.resize(platoon.size());
+  for(size_t i = 0; i < platoon.size(); i++){
+    vehicles_[i].index = platoon[i];
+    vehicles_[i].data.src_index = index_;
+    vehicles_[i].data.tar_index = platoon[i];
+    position_[platoon[i]] = i;
+  }
 
-  time_flag_ = false;
-  sampling_time1_ = 0.1;
-  sampling_time2_ = 0.1;
+  stats_.reset(new StatsShm::StatsWriter("crc"));
+  printf("CRC is running with %zu trucks ... (status: stc_top crc)\n", vehicles_.size());
 
-  if(ZMQ_SOCKET_.rep_flag0_){
-    repThread0_ = std::thread(&CentralRC::reply, this, lv_data_);
-  }
-  if(ZMQ_SOCKET_.rep_flag1_){
-    repThread1_ = std::thread(&CentralRC::reply, this, fv1_data_);
-  }
-  if(ZMQ_SOCKET_.rep_flag2_){
-    repThread2_ = std::thread(&CentralRC::reply, this, fv2_data_);
+  for(Vehicle& vehicle : vehicles_){
+    ZMQ_SOCKET_.onReply(&vehicle.data,
+      [this](ZmqData* send){ send->crc_mode = crc_mode_; },
+      [this](ZmqData* recv){ updateData(recv); });
   }
 }
 
-void CentralRC::reply(ZmqData* zmq_data){
-  ZmqData tmp;
-  while(is_node_running_){
-    {
-      std::scoped_lock lock(data_mutex_);
-      tmp = *zmq_data;
-      tmp.crc_mode = crc_mode_;
-    }
-    if(zmq_data->tar_index == 10){  //LV
-      ZMQ_SOCKET_.replyZMQ(&tmp);
-    }
-    else if(zmq_data->tar_index == 11){  //FV1
-      ZMQ_SOCKET_.replyZMQ(&tmp);
-    }
-    else if(zmq_data->tar_index == 12){  //FV2
-      ZMQ_SOCKET_.replyZMQ(&tmp);
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(2));
-  }
+void CentralRC::run(){
+  ZMQ_SOCKET_.addTimer(5, [this](){ communicate(); });
+  ZMQ_SOCKET_.spin();
+}
+
+void CentralRC::stop(){
+  is_node_running_ = false;
+  ZMQ_SOCKET_.controlDone_ = true;
 }
 
-void CentralRC::estimateVelocity(uint8_t index){
-  assert(index < 13 || index > 9);
+/* A working encoder is used as is. Otherwise the nearest truck with one, the
+ * preceding side first, plus the gap rates between the two: a follower's gap
+ * grows at the speed of its predecessor minus its own.
+ * Against the three truck code this changes two cases: a failed LV is
+ * estimated from FV1 over one gap (was FV2 over two, the FV1 branch was dead),
+ * and every predecessor based estimate is low pass filtered (was FV1 only).
+ * Both cut the gap rate spikes, see crc_bench */
+void CentralRC::estimateVelocity(size_t pos){
   std::scoped_lock lock(data_mutex_);
+  Vehicle& vehicle = vehicles_[pos];
 
-  if (index == 10){  //LV
-    if (!lv_data_->alpha){
-      lv_data_->est_vel = lv_data_->cur_vel;
-    }
-    else if (lv_data_->alpha && !lv_data_->alpha){
-        lv_data_->est_vel = ((fv1_data_->cur_dist - fv1_prev_dist_) / sampling_time1_) + fv1_data_->cur_vel;
-    }
-    else if ((lv_data_->alpha || fv1_data_->alpha) && !fv2_data_->alpha){
-        lv_data_->est_vel = ((fv1_data_->cur_dist - fv1_prev_dist_) / sampling_time1_) + ((fv2_data_->cur_dist - fv2_prev_dist_) / sampling_time2_) + fv2_data_->cur_vel;
-    }
-    else{  //All trucks' velocity sensors are fail 
-      crc_mode_ = 2;
-      lv_data_->crc_mode = crc_mode_;
-    }
+  if (!vehicle.data.alpha){
+    vehicle.data.est_vel = vehicle.data.cur_vel;
+    return;
   }
-  else if (index == 11){  //FV1
-    float origin_est_vel;
-    if (!fv1_data_->alpha){
-      fv1_data_->est_vel = fv1_data_->cur_vel;
-    }
-    else if (fv1_data_->alpha && !lv_data_->alpha){
-      origin_est_vel = ((-1.0f) * ((fv1_data_->cur_dist - fv1_prev_dist_) / sampling_time1_)) + lv_data_->cur_vel;
-      fv1_est_vel_tmp_ = origin_est_vel;
-      fv1_data_->est_vel = lowPassFilter(sampling_time1_, origin_est_vel);
-    }
-    else if ((fv1_data_->alpha || lv_data_->alpha) && !fv2_data_->alpha){
-      fv1_data_->est_vel = ((fv2_data_->cur_dist - fv2_prev_dist_) / sampling_time2_) + fv2_data_->cur_vel;
+  for (size_t hops = 1; hops < vehicles_.size(); hops++){
+    if (hops <= pos && !vehicles_[pos - hops].data.alpha){
+      float origin_est_vel = vehicles_[pos - hops].data.cur_vel - gapRate(pos - hops + 1, pos);
+      vehicle.data.est_vel = lowPassFilter(&vehicle, origin_est_vel);
+      return;
     }
-    else{  //All trucks' velocity sensors are fail
-      crc_mode_ = 2;
-      fv1_data_->crc_mode = crc_mode_;
+    if (pos + hops < vehicles_.size() && !vehicles_[pos + hops].data.alpha){
+      vehicle.data.est_vel = vehicles_[pos + hops].data.cur_vel + gapRate(pos + 1, pos + hops);
+      return;
     }
   }
-  else if (index == 12){  //FV2
-    if (!fv2_data_->alpha){
-      fv2_data_->est_vel = fv2_data_->cur_vel;
-    }
-    else if (fv2_data_->alpha && !fv1_data_->alpha){
-        fv2_data_->est_vel = ((-1.0f) * ((fv2_data_->cur_dist - fv2_prev_dist_) / sampling_time2_)) + fv1_data_->cur_vel;
-    }
-    else if ((fv2_data_->alpha || fv1_data_->alpha) && !lv_data_->alpha){
-        fv2_data_->est_vel = ((-1.0f) * ((fv1_data_->cur_dist - fv1_prev_dist_) / sampling_time1_)) + ((-1.0f) * ((fv2_data_->cur_dist - fv2_prev_dist_) / sampling_time2_)) + lv_data_->cur_vel;
-    }
-    else{  //All trucks' velocity sensors are fail
-      crc_mode_ = 2;
-      fv2_data_->crc_mode = crc_mode_;
-    }
+  //All trucks' velocity sensors are fail
+  crc_mode_ = 2;
+  vehicle.data.crc_mode = crc_mode_;
+}
+
+/* Sum of the gap rates of trucks first..last, each measures the gap to its predecessor */
+float CentralRC::gapRate(size_t first, size_t last) const{
+  float rate = 0.f;
+  for (size_t i = first; i <= last; i++){
+    const Vehicle& vehicle = vehicles_[i];
+    rate += (vehicle.data.cur_dist - vehicle.prev_dist) / vehicle.sampling_time;
   }
+  return rate;
 }
 
-void CentralRC::statusCheck(ZmqData *lv_data, ZmqData *fv1_data, ZmqData *fv2_data){
-  uint8_t lv_mode = lv_data->lrc_mode;
-  uint8_t fv1_mode = fv1_data->lrc_mode;
-  uint8_t fv2_mode = fv2_data->lrc_mode;
+void CentralRC::statusCheck(){
+  bool all_tm = true, all_rcm = true, any_gdm = false;
+  for (const Vehicle& vehicle : vehicles_){
+    all_tm &= (vehicle.data.lrc_mode == 0);
+    all_rcm &= (vehicle.data.lrc_mode == 1);
+    any_gdm |= (vehicle.data.lrc_mode == 2);
+  }
 
-  if ((lv_mode == 0) && (fv1_mode == 0) && (fv2_mode == 0)){
+  if (all_tm){
     crc_mode_ = 0;
   }
-  else if (((lv_mode == 2) || (fv1_mode == 2) || (fv2_mode == 2)) || ((lv_mode == 1) && (fv1_mode == 1) && (fv2_mode == 1))){
+  else if (any_gdm || all_rcm){
     crc_mode_ = 2;
-    //crc_mode_ = 1;
   }
   else{
     crc_mode_ = 1;
   }
 
-  if (fv1_data->beta && fv1_data->gamma){
-    lv_data->send_rear_camera_image = true;
-  }
-  else lv_data->send_rear_camera_image = false;
-
-  if (fv2_data->beta && fv2_data->gamma){
-    fv1_data->send_rear_camera_image = true;
+  //a truck's rear camera stands in for the follower's camera and lidar
+  for (size_t i = 0; i < vehicles_.size(); i++){
+    const ZmqData* follower = (i + 1 < vehicles_.size()) ? &vehicles_[i + 1].data : nullptr;
+    vehicles_[i].data.send_rear_camera_image = follower && follower->beta && follower->gamma;
   }
-  else fv1_data->send_rear_camera_image = false;
-
 }
 
-float CentralRC::lowPassFilter(float sampling_time, float pred_vel){
+float CentralRC::lowPassFilter(Vehicle* vehicle, float pred_vel){
   float res = 0.f;
-  res = (tau_*prev_res_ + sampling_time*pred_vel)/(tau_+sampling_time);
-  prev_res_ = res;
+  res = (tau_*vehicle->filtered_vel + vehicle->sampling_time*pred_vel)/(tau_+vehicle->sampling_time);
+  vehicle->filtered_vel = res;
   return res;
 }
 
@@ -164,7 +129,8 @@ void CentralRC::recordData(struct timeval *startTime){
   struct timeval currentTime;
   char file_name[] = "CRC_log00.csv";
   static char file[128] = {0x00, };
-  char buf[512] = {0x00,};
+  char buf[128] = {0x00,};
+  std::string line;
   static bool flag = false;
   std::ifstream read_file;
   std::ofstream write_file;
@@ -181,127 +147,130 @@ void CentralRC::recordData(struct timeval *startTime){
       }
       read_file.close();
     }
-    write_file << "Time,Tar_vel0,Ref_vel0,Cur_vel0,Tar_dist0,Cur_dist0,Tar_vel1,Ref_vel1,Cur_vel1,Tar_dist1,Cur_dist1,Tar_vel2,Ref_vel2,Cur_vel2,Tar_dist2,Cur_dist2,Alpha0,Beta0,Gamma0,Alpha1,Beta1,Gamma1,Alpha2,Beta2,Gamma2,LRC_mode0,LRC_mode1,LRC_mode2,CRC_mode" << std::endl; //seconds
+    line = "Time";
+    for(size_t i = 0; i < vehicles_.size(); i++){
+      snprintf(buf, sizeof(buf), ",Tar_vel%zu,Ref_vel%zu,Cur_vel%zu,Tar_dist%zu,Cur_dist%zu", i, i, i, i, i);
+      line += buf;
+    }
+    for(size_t i = 0; i < vehicles_.size(); i++){
+      snprintf(buf, sizeof(buf), ",Alpha%zu,Beta%zu,Gamma%zu", i, i, i);
+      line += buf;
+    }
+    for(size_t i = 0; i < vehicles_.size(); i++){
+      snprintf(buf, sizeof(buf), ",LRC_mode%zu", i);
+      line += buf;
+    }
+    write_file << line << ",CRC_mode" << std::endl; //seconds
     flag = true;
  }
   else{
     std::scoped_lock lock(data_mutex_);
     gettimeofday(&currentTime, NULL);
     time_ = ((currentTime.tv_sec - startTime->tv_sec)) + ((currentTime.tv_usec - startTime->tv_usec)/1000000.0);
-    sprintf(buf, "%.10e,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d", time_, lv_data_->tar_vel, lv_data_->ref_vel, lv_data_->cur_vel, lv_data_->tar_dist, lv_data_->cur_dist, fv1_data_->tar_vel, fv1_data_->ref_vel, fv1_data_->cur_vel, fv1_data_->tar_dist, fv1_data_->cur_dist, fv2_data_->tar_vel, fv2_data_->ref_vel, fv2_data_->cur_vel, fv2_data_->tar_dist, fv2_data_->cur_dist, lv_data_->alpha, lv_data_->beta, lv_data_->gamma, fv1_data_->alpha, fv1_data_->beta, fv1_data_->gamma, fv2_data_->alpha, fv2_data_->beta, fv2_data_->gamma, lv_data_->lrc_mode, fv1_data_->lrc_mode, fv2_data_->lrc_mode, crc_mode_);
+    snprintf(buf, sizeof(buf), "%.10e", time_);
+    line = buf;
+    for(const Vehicle& vehicle : vehicles_){
+      const ZmqData& data = vehicle.data;
+      snprintf(buf, sizeof(buf), ",%.3f,%.3f,%.3f,%.3f,%.3f", data.tar_vel, data.ref_vel, data.cur_vel, data.tar_dist, data.cur_dist);
+      line += buf;
+    }
+    for(const Vehicle& vehicle : vehicles_){
+      snprintf(buf, sizeof(buf), ",%d,%d,%d", vehicle.data.alpha, vehicle.data.beta, vehicle.data.gamma);
+      line += buf;
+    }
+    for(const Vehicle& vehicle : vehicles_){
+      snprintf(buf, sizeof(buf), ",%d", vehicle.data.lrc_mode);
+      line += buf;
+    }
+    snprintf(buf, sizeof(buf), ",%d", crc_mode_);
     write_file.open(file, std::ios::out | std::ios::app);
-    write_file << buf << std::endl;
+    write_file << line << buf << std::endl;
   }
   write_file.close();
 }
 
-void CentralRC::printStatus(){
-  printf("\033[2J\033[1;1H");
-  printf("CRC is running ...\n");
-  printf("CRC and each MODEs of LV, FV1, FV2:\t%d || %d, %d, %d\n", crc_mode_, lv_data_->lrc_mode, fv1_data_->lrc_mode, fv2_data_->lrc_mode);
-  printf("Predict Velocitys of LV, FV1, FV2:\t%.3f, %.3f, %.3f\n", lv_data_->est_vel, fv1_data_->est_vel, fv2_data_->est_vel);
-  printf("Sampling_time_:\t%.6f, %.6f\n", sampling_time1_, sampling_time2_);
-  printf("LV velocity:\t%.3f\n", lv_data_->cur_vel);
-  printf("FV1 velocity:\t%.3f\n", fv1_data_->cur_vel);
-  printf("FV2 velocity:\t%.3f\n", fv2_data_->cur_vel);
-  printf("LV current distance:\t%.3f\n", lv_data_->cur_dist);
-  printf("FV1 current distance:\t%.3f\n", fv1_data_->cur_dist);
-  printf("FV2 current distance:\t%.3f\n", fv2_data_->cur_dist);
-  printf("Size:\t%zu\n", sizeof(*lv_data_));
+void CentralRC::updateStats(){
+  if (++stats_cnt_ < 10) return;
+  stats_cnt_ = 0;
+
+  stats_->begin("CRC");
+  stats_->printf("CRC mode:\t%d, %zu trucks, cycle %.3f ms (max %.3f)", crc_mode_, vehicles_.size(), cycle_ms_.load(), cycle_max_ms_.exchange(0.0f));
+  stats_->printf("Truck  LRC  mode  qos  vel     est     dist    dt ms   link ms  image ms");
+  for (size_t i = 0; i < vehicles_.size(); i++){
+    const Vehicle& vehicle = vehicles_[i];
+    char name[16];
+    if (i == 0) snprintf(name, sizeof(name), "LV");
+    else snprintf(name, sizeof(name), "FV%zu", i);
+    stats_->printf("%-6s %-4u %-5u %-4u %-7.3f %-7.3f %-7.3f %-7.2f %-8.2f %.2f", name, (unsigned)vehicle.index, (unsigned)vehicle.data.lrc_mode, (unsigned)vehicle.data.qos_level,
+      vehicle.data.cur_vel, vehicle.data.est_vel, vehicle.data.cur_dist, vehicle.sampling_time * 1000.0, vehicle.link_age, vehicle.image_age);
+  }
+  stats_->printf("Wire:\t%zu bytes (beacon %zu), errors %u", ZmqWire::TELEMETRY_SIZE, ZmqWire::BEACON_SIZE, ZMQ_SOCKET_.wire_errors_.load());
+  for(const std::string& line : ZMQ_SOCKET_.healthReport()) stats_->printf("%s", line.c_str());
+  stats_->commit();
 }
 
 void CentralRC::updateData(ZmqData* zmq_data){
   std::scoped_lock lock(data_mutex_);
-  if(zmq_data->tar_index == 30){
-    if(zmq_data->src_index == 10){
-      lv_data_->tar_vel = zmq_data->tar_vel;
-      lv_data_->ref_vel = zmq_data->ref_vel;
-      lv_data_->cur_vel = zmq_data->cur_vel;
-      lv_data_->tar_dist = zmq_data->tar_dist;
-      lv_data_->cur_dist = zmq_data->cur_dist;
-      lv_data_->alpha = zmq_data->alpha;
-      lv_data_->beta = zmq_data->beta;
-      lv_data_->gamma = zmq_data->gamma;
-      lv_data_->lrc_mode = zmq_data->lrc_mode;
-    }
-    else if(zmq_data->src_index == 11){
-      fv1_data_->tar_vel = zmq_data->tar_vel;
-      fv1_data_->ref_vel = zmq_data->ref_vel;
-      fv1_data_->cur_vel = zmq_data->cur_vel;
-      fv1_data_->preceding_truck_vel = lv_data_->cur_vel;
-      fv1_data_->tar_dist = zmq_data->tar_dist;
-      fv1_data_->cur_dist = zmq_data->cur_dist;
-      fv1_data_->alpha = zmq_data->alpha;
-      fv1_data_->beta = zmq_data->beta;
-      fv1_data_->gamma = zmq_data->gamma;
-      fv1_data_->lrc_mode = zmq_data->lrc_mode;
-      getSamplingTime(fv1_data_->cur_dist, fv1_prev_dist_, 1);
-    }
-    else if(zmq_data->src_index == 12){
-      fv2_data_->tar_vel = zmq_data->tar_vel;
-      fv2_data_->ref_vel = zmq_data->ref_vel;
-      fv2_data_->cur_vel = zmq_data->cur_vel;
-      fv2_data_->preceding_truck_vel = fv1_data_->cur_vel;
-      fv2_data_->tar_dist = zmq_data->tar_dist;
-      fv2_data_->cur_dist = zmq_data->cur_dist;
-      fv2_data_->alpha = zmq_data->alpha;
-      fv2_data_->beta = zmq_data->beta;
-      fv2_data_->gamma = zmq_data->gamma;
-      fv2_data_->lrc_mode = zmq_data->lrc_mode;
-      getSamplingTime(fv2_data_->cur_dist, fv2_prev_dist_, 2);
-    }
-  }
-}
+  if(zmq_data->tar_index != index_ || position_[zmq_data->src_index] < 0) return;
+  size_t pos = position_[zmq_data->src_index];
+  Vehicle& vehicle = vehicles_[pos];
 
-bool CentralRC::getSamplingTime(float cur_dist, float prev_dist, int idx){
-  bool get_flag = false;
-  if(!time_flag_){
-    gettimeofday(&start_time1_, NULL);
-    gettimeofday(&start_time2_, NULL);
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    time_flag_ = true;
+  if(zmq_data->clock_synced){
+    vehicle.link_age = ageMs(zmq_data->send_stamp);
+    vehicle.image_age = ageMs(zmq_data->image_stamp);
   }
-  if(time_flag_ && (cur_dist != prev_dist) && idx == 1){
-    gettimeofday(&end_time1_, NULL);
-    sampling_time1_ = (end_time1_.tv_sec - start_time1_.tv_sec) + ((end_time1_.tv_usec - start_time1_.tv_usec)/1000000.0);  //seconds
-    if (sampling_time1_ > 0.1f) sampling_time1_ = 0.1f;
-    get_flag = true;
-    gettimeofday(&start_time1_, NULL);
+  vehicle.data.tar_vel = zmq_data->tar_vel;
+  vehicle.data.ref_vel = zmq_data->ref_vel;
+  vehicle.data.cur_vel = zmq_data->cur_vel;
+  vehicle.data.tar_dist = zmq_data->tar_dist;
+  vehicle.data.cur_dist = zmq_data->cur_dist;
+  vehicle.data.alpha = zmq_data->alpha;
+  vehicle.data.beta = zmq_data->beta;
+  vehicle.data.gamma = zmq_data->gamma;
+  vehicle.data.lrc_mode = zmq_data->lrc_mode;
+  vehicle.data.qos_level = zmq_data->qos_level;
+  if(pos > 0){  //followers measure the gap to their predecessor
+    vehicle.data.preceding_truck_vel = vehicles_[pos - 1].data.cur_vel;
+    getSamplingTime(&vehicle);
   }
-  if(time_flag_ && (cur_dist != prev_dist) && idx == 2){
-    gettimeofday(&end_time2_, NULL);
-    sampling_time2_ = (end_time2_.tv_sec - start_time2_.tv_sec) + ((end_time2_.tv_usec - start_time2_.tv_usec)/1000000.0);  //seconds
-    if (sampling_time2_ > 0.1f) sampling_time2_ = 0.1f;
-    get_flag = true;
-    gettimeofday(&start_time2_, NULL);
+}
+
+/* Time between two cur_dist updates of a follower, the first one only starts the clock */
+bool CentralRC::getSamplingTime(Vehicle* vehicle){
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  if(vehicle->sample_start.tv_sec == 0){
+    vehicle->sample_start = now;
+    return false;
   }
-  return get_flag;
+  if(vehicle->data.cur_dist == vehicle->prev_dist) return false;
+
+  vehicle->sampling_time = (now.tv_sec - vehicle->sample_start.tv_sec) + ((now.tv_usec - vehicle->sample_start.tv_usec)/1000000.0);  //seconds
+  if (vehicle->sampling_time > 0.1f) vehicle->sampling_time = 0.1f;
+  vehicle->sample_start = now;
+  return true;
 }
 
 void CentralRC::communicate(){  
+  auto start = std::chrono::steady_clock::now();
   {
     std::scoped_lock lock(data_mutex_);
-    statusCheck(lv_data_, fv1_data_, fv2_data_);
+    statusCheck();
   }
 
-  updateData(ZMQ_SOCKET_.rep_recv0_);
-  updateData(ZMQ_SOCKET_.rep_recv1_);
-  updateData(ZMQ_SOCKET_.rep_recv2_);
-
-  estimateVelocity(10);
-  estimateVelocity(11);
-  estimateVelocity(12);
+  for(size_t i = 0; i < vehicles_.size(); i++) estimateVelocity(i);
   
   recordData(&launch_time_);
 
   {
     std::scoped_lock lock(data_mutex_);
-    fv1_prev_dist_ = fv1_data_->cur_dist;
-    fv2_prev_dist_ = fv2_data_->cur_dist;
+    for(Vehicle& vehicle : vehicles_) vehicle.prev_dist = vehicle.data.cur_dist;
   }
 
-  printStatus();
-  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  float cycle = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  cycle_ms_ = 0.9f * cycle_ms_ + 0.1f * cycle;
+  if(cycle > cycle_max_ms_) cycle_max_ms_ = cycle;
+  updateStats();
 }
 
 }
@@ -0,0 +1,251 @@
+#include "includes/crc.hpp"
+
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <random>
+
+/* CRC load test: one CentralRC against N simulated LRCs, each a DEALER that
+ * sends telemetry every SEND_PERIOD like the real ones. The trucks drive with
+ * consistent kinematics, the gaps are measured once per SCAN_PERIOD with
+ * noise. Every 4th truck has a failed encoder so the gap chains are exercised,
+ * then a 3 truck platoon runs with each truck's encoder failed in turn.
+ *
+ *   crc_bench [seconds] [endpoint] [trucks ...]   10, ipc:///tmp/crc_bench.ipc, 3 10 32
+ *
+ * update latency: LRC send -> CRC reply acking it, includes the CRC's hold
+ *                 until its next send tick (up to SEND_PERIOD)
+ * cycle:          communicate() run time on the reactor thread
+ * cpu:            CRC reactor thread, share of one core
+ * est error:      est_vel in the CRC replies - true velocity, failed encoders only
+ */
+
+namespace {
+
+#define SCAN_PERIOD 100  // milliseconds between gap measurements
+#define GAP_NOISE 0.005f  // m, std dev of a gap measurement
+
+typedef struct SimTruck{
+  zmq::socket_t socket;
+  ZmqData data;
+  uint32_t seq = 0;
+  int64_t sent[SEND_LOG] = {0,};  // steady ns, slot seq % SEND_LOG
+  uint32_t sent_seq[SEND_LOG] = {0,};
+  bool rx_valid = false;
+  uint32_t rx_seq = 0;
+  std::chrono::steady_clock::time_point rx_time;
+  double x = 0.0;  // m, true position
+  double v = 0.0;  // m/s, true velocity
+}SimTruck;
+
+typedef struct Result{
+  size_t trucks;
+  double msgs;  // telemetry per second, both directions
+  double p50, p99, max;  // ms, update latency
+  float cycle, cycle_max;  // ms
+  double cpu;  // %
+  uint32_t missing;  // trucks the CRC never answered
+  double est_rms, est_max;  // m/s
+  int failed;  // platoon position with the failed encoder, -1 = every 4th
+}Result;
+
+int64_t nowNs(){
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+double threadCpuS(pthread_t thread){
+  clockid_t clock;
+  struct timespec ts;
+  if(pthread_getcpuclockid(thread, &clock) != 0 || clock_gettime(clock, &ts) != 0) return 0.0;
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* LRC indices from 10, skipping the control center (20) and the CRC (30) */
+std::vector<uint8_t> platoon(size_t trucks){
+  std::vector<uint8_t> indices;
+  for(int index = 10; indices.size() < trucks && index < 255; index++){
+    if(index != 20 && index != 30) indices.push_back(index);
+  }
+  return indices;
+}
+
+double trueVel(double t, size_t pos){
+  return 0.8 + 0.1 * sin(t + 0.5 * pos);
+}
+
+Result run(size_t trucks, double seconds, const std::string& endpoint, int failed = -1){
+  std::vector<uint8_t> indices = platoon(trucks);
+  CentralResiliencyCoordinator::CentralRC crc(indices, endpoint);
+  gettimeofday(&crc.launch_time_, NULL);
+  std::thread reactor([&crc]() { crc.run(); });
+
+  zmq::context_t context(1);
+  std::vector<SimTruck> sim(indices.size());
+  std::vector<zmq::pollitem_t> items;
+  for(size_t i = 0; i < sim.size(); i++){
+    sim[i].socket = zmq::socket_t(context, ZMQ_DEALER);
+    sim[i].socket.setsockopt(ZMQ_LINGER, 0);
+    sim[i].socket.connect(endpoint);
+    sim[i].data.src_index = indices[i];
+    sim[i].data.tar_index = 30;
+    sim[i].data.alpha = (failed < 0) ? (i % 4 == 3) : ((int)i == failed);
+    sim[i].x = -0.8 * i;
+    sim[i].v = trueVel(0.0, i);
+    items.push_back({ sim[i].socket, 0, ZMQ_POLLIN, 0 });
+  }
+
+  std::mt19937 rng(1);
+  std::normal_distribution<float> gap_noise(0.0f, GAP_NOISE);
+  std::vector<double> latency;
+  double est_sq = 0.0, est_max = 0.0;
+  uint64_t est_n = 0;
+  std::vector<bool> answered(sim.size(), false);
+  uint64_t msgs = 0;
+  double cpu_start = 0.0;
+  float cycle_max = 0.0f;  // the stats page resets the CRC's own every 10 cycles
+  auto start = std::chrono::steady_clock::now();
+  auto measure = start + std::chrono::seconds(1);  //warm-up: connects, first samples
+  auto end = measure + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+  auto next = start;
+  auto next_scan = start;
+  bool measuring = false;
+
+  while(std::chrono::steady_clock::now() < end){
+    auto now = std::chrono::steady_clock::now();
+    if(!measuring && now >= measure){
+      measuring = true;
+      cpu_start = threadCpuS(reactor.native_handle());
+      crc.cycle_max_ms_ = 0.0f;
+    }
+    if(measuring) cycle_max = std::max(cycle_max, crc.cycle_max_ms_.load());
+
+    if(now >= next){
+      double t = std::chrono::duration<double>(now - start).count();
+      bool scan = (now >= next_scan);
+      if(scan) next_scan += std::chrono::milliseconds(SCAN_PERIOD);
+      for(size_t i = 0; i < sim.size(); i++){
+        SimTruck& truck = sim[i];
+        truck.x += truck.v * SEND_PERIOD / 1000.0;
+        truck.v = trueVel(t, i);
+        truck.data.cur_vel = truck.data.alpha ? 0.0f : truck.v;
+        if(i > 0 && scan) truck.data.cur_dist = sim[i - 1].x - truck.x + gap_noise(rng);
+        gettimeofday(&truck.data.send_stamp, NULL);
+
+        ZmqWire::Ack ack;
+        if(truck.rx_valid){
+          ack.seq = truck.rx_seq;
+          ack.delay_us = std::chrono::duration_cast<std::chrono::microseconds>(now - truck.rx_time).count();
+          ack.valid = true;
+        }
+        truck.sent[truck.seq % SEND_LOG] = nowNs();
+        truck.sent_seq[truck.seq % SEND_LOG] = truck.seq;
+        uint8_t buf[ZmqWire::MAX_SIZE];
+        zmq::message_t msg(buf, ZmqWire::encode(truck.data, ZmqWire::MSG_TELEMETRY, truck.seq++, buf, &ack));
+        truck.socket.send(msg, ZMQ_DONTWAIT);
+        if(measuring) msgs++;
+      }
+      next += std::chrono::milliseconds(SEND_PERIOD);
+      if(next < now) next = now + std::chrono::milliseconds(SEND_PERIOD);
+    }
+
+    long timeout = std::max(0L, (long)std::chrono::duration_cast<std::chrono::milliseconds>(next - std::chrono::steady_clock::now()).count());
+    zmq::poll(items.data(), items.size(), timeout);
+    for(size_t i = 0; i < sim.size(); i++){
+      if(!(items[i].revents & ZMQ_POLLIN)) continue;
+      SimTruck& truck = sim[i];
+      zmq::message_t msg;
+      while(truck.socket.recv(&msg, ZMQ_DONTWAIT)){
+        ZmqData reply;
+        uint32_t seq;
+        ZmqWire::Ack ack;
+        if(!ZmqWire::decode(msg.data(), msg.size(), &reply, &seq, &ack)) continue;
+        truck.rx_valid = true;
+        truck.rx_seq = seq;
+        truck.rx_time = std::chrono::steady_clock::now();
+        answered[i] = true;
+        if(!measuring) continue;
+        msgs++;
+
+        int slot = ack.seq % SEND_LOG;
+        if(ack.valid && truck.sent_seq[slot] == ack.seq) latency.push_back((nowNs() - truck.sent[slot]) / 1e6);
+        if(truck.data.alpha && reply.crc_mode != 2){
+          double err = fabs(reply.est_vel - truck.v);
+          est_sq += err * err;
+          est_max = std::max(est_max, err);
+          est_n++;
+        }
+      }
+    }
+  }
+
+  Result result;
+  result.trucks = trucks;
+  result.cpu = 100.0 * (threadCpuS(reactor.native_handle()) - cpu_start) / seconds;
+  result.cycle = crc.cycle_ms_;
+  result.cycle_max = cycle_max;
+  result.msgs = msgs / seconds;
+  result.missing = std::count(answered.begin(), answered.end(), false);
+  result.est_rms = est_n ? sqrt(est_sq / est_n) : 0.0;
+  result.est_max = est_max;
+  result.failed = failed;
+
+  crc.stop();
+  reactor.join();
+
+  std::sort(latency.begin(), latency.end());
+  result.p50 = latency.empty() ? 0.0 : latency[latency.size() / 2];
+  result.p99 = latency.empty() ? 0.0 : latency[latency.size() * 99 / 100];
+  result.max = latency.empty() ? 0.0 : latency.back();
+  return result;
+}
+
+int usage(const char* name){
+  fprintf(stderr, "usage: %s [seconds] [endpoint] [trucks ...]\n", name);
+  fprintf(stderr, "  10 s, ipc:///tmp/crc_bench.ipc and 3 10 32 trucks by default, at most %zu trucks\n", platoon(255).size());
+  return 1;
+}
+
+}
+
+int main(int argc, char *argv[]){
+  double seconds = 10.0;
+  if(argc > 1){
+    char* end;
+    seconds = strtod(argv[1], &end);
+    if(end == argv[1] || *end != '\0' || !(seconds > 0.0)){
+      fprintf(stderr, "invalid run time '%s'\n", argv[1]);
+      return usage(argv[0]);
+    }
+  }
+  std::string endpoint = (argc > 2) ? argv[2] : "ipc:///tmp/crc_bench.ipc";
+  std::vector<size_t> sizes;
+  for(int i = 3; i < argc; i++){
+    char* end;
+    errno = 0;
+    long trucks = strtol(argv[i], &end, 10);
+    if(end == argv[i] || *end != '\0' || errno == ERANGE || trucks <= 0 || (size_t)trucks > platoon(255).size()){
+      fprintf(stderr, "invalid truck count '%s'\n", argv[i]);
+      return usage(argv[0]);
+    }
+    sizes.push_back(trucks);
+  }
+  if(sizes.empty()) sizes = {3, 10, 32};
+
+  std::vector<Result> results;
+  for(size_t trucks : sizes) results.push_back(run(trucks, seconds, endpoint));
+  std::vector<Result> estimates;
+  for(int failed = 0; failed < 3; failed++) estimates.push_back(run(3, seconds, endpoint, failed));
+
+  printf("\n%zu s per run, %s, telemetry every %d ms, gaps every %d ms\n", (size_t)seconds, endpoint.c_str(), SEND_PERIOD, SCAN_PERIOD);
+  printf("trucks  msg/s    latency p50 / p99 / max ms   cycle avg / max ms   crc cpu  unanswered  est error rms / max m/s\n");
+  for(const Result& r : results){
+    printf("%-7zu %-8.0f %6.2f / %6.2f / %6.2f       %6.3f / %6.3f      %5.1f %%  %-10u  %.3f / %.3f\n",
+      r.trucks, r.msgs, r.p50, r.p99, r.max, r.cycle, r.cycle_max, r.cpu, r.missing, r.est_rms, r.est_max);
+  }
+  printf("\n3 trucks, one failed encoder  est error rms / max m/s\n");
+  const char* names[3] = {"LV", "FV1", "FV2"};
+  for(const Result& r : estimates){
+    printf("%-29s  %.3f / %.3f\n", names[r.failed], r.est_rms, r.est_max);
+  }
+  return 0;
+}
@@ -1,51 +1,71 @@
 #include <fstream>
+#include <memory>
 #include "zmq_class.h"
+#include "stats_shm/stats_shm.hpp"
 
 namespace CentralResiliencyCoordinator{
 
+/* One truck of the platoon as the CRC sees it. data holds the newest LRC
+ * telemetry and is also the reply, est_vel, crc_mode and the rear image
+ * flag go back to the LRC in it */
+typedef struct Vehicle{
+  uint8_t index = 255;  // LRC index on the wire
+  ZmqData data;
+
+  float prev_dist = 0.8f;  // cur_dist one cycle ago
+  float sampling_time = 0.1f;  // seconds between cur_dist updates, at most 0.1
+  struct timeval sample_start = {0, 0};
+  float filtered_vel = 0.8f;  // low pass state of the estimate from the preceding trucks
+
+  double link_age = 0.0;  // ms since the LRC sent
+  double image_age = 0.0;  // ms since the camera frame behind it
+}Vehicle;
+
 class CentralRC{
   public:
-    CentralRC();
+    /* LRC indices in platoon order, the LV first. 20 (control center) and 30 (CRC) are taken */
+    explicit CentralRC(const std::vector<uint8_t>& platoon = {10, 11, 12}, const std::string& rep_endpoint = "");
     ~CentralRC();
 
     struct timeval launch_time_;
-    void communicate();
+    void run();  // serves the LRC links and runs communicate() every 5 ms
+    void stop();
     bool is_node_running_;
 
+    std::atomic<float> cycle_ms_{0.0f};  // communicate() run time, smoothed
+    std::atomic<float> cycle_max_ms_{0.0f};  // since the last stats page
+
   private:
     ZMQ_CLASS ZMQ_SOCKET_;
 
-    void init();
-    void reply(ZmqData* zmq_data);
-    void estimateVelocity(uint8_t index);
-    void statusCheck(ZmqData *lv_data, ZmqData *fv1_data, ZmqData *fv2_data);
+    void init(const std::vector<uint8_t>& platoon);
+    void communicate();
+    void estimateVelocity(size_t pos);
+    float gapRate(size_t first, size_t last) const;
+    void statusCheck();
     void recordData(struct timeval *time);
-    void printStatus();
+    void updateStats();
     void updateData(ZmqData* zmq_data);
-    bool getSamplingTime(float cur_dist, float prev_dist, int idx);
-    float lowPassFilter(float sampling_time, float pred_vel);
+    bool getSamplingTime(Vehicle* vehicle);
+    float lowPassFilter(Vehicle* vehicle, float pred_vel);
 
-    bool time_flag_;
     uint8_t index_;
     uint8_t crc_mode_;
 
-    ZmqData *lv_data_, *fv1_data_, *fv2_data_;
+    std::vector<Vehicle> vehicles_;  // platoon order, fixed after init, ZMQ_CLASS keeps pointers into it
+    int position_[256];  // LRC index -> vehicles_, -1 = not in the platoon
 
     float tau_ = 0.5f;
-    float fv1_est_vel_tmp_ = 0.f;
-    float prev_res_ = 0.8f;
 
-    float fv1_prev_dist_, fv2_prev_dist_;
-    float lv_est_vel_, fv1_est_vel_, fv2_est_vel_;
-    float sampling_time1_, sampling_time2_;
     std::string log_path_ = "/home/avees/logfiles/";
 
-    struct timeval start_time1_, start_time2_, end_time1_, end_time2_;
     double time_;
 
-    std::thread repThread0_, repThread1_, repThread2_;
+    //status page for stc_top, refreshed every 10th cycle
+    std::unique_ptr<StatsShm::StatsWriter> stats_;
+    int stats_cnt_ = 0;
+
     std::mutex data_mutex_;
 };
 
 }
-
@@ -10,88 +10,173 @@
 
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
 #include <boost/format.hpp>
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <atomic>
 #include <vector>
+#include <functional>
+#include <memory>
 
 #include <zmq.hpp>
 
-#define DATASIZE 84
-
-typedef struct LaneCoef{
-	float a = 0.0f;
-	float b = 0.0f;
-	float c = 0.0f;
-}LaneCoef;
-
-typedef struct ImgData{
-	uint8_t src_index = 255;
-	uint8_t tar_index = 255;
-
-	struct timeval startTime;
-
-	u_char comp_image[100000] = {0,};
-	size_t size = 0;
-}ImgData;
-
-typedef struct ZmqData{
-	//Control center = 20, CRC = 30, LRC = 10, 11, 12, LV = 0, FV1 = 1, FV2 = 2
-	uint8_t src_index = 255;
-	uint8_t tar_index = 255;
-
-	//sensor failure
-	bool fi_encoder = false;
-	bool fi_camera = false;
-	bool fi_lidar = false;
-	bool alpha = false;
-	bool beta = false;
-	bool gamma = false;
-
-	//flag to send rear camera sensor image
-	bool send_rear_camera_image = false;
-
-	float ref_vel = 0.0f;
-	float cur_vel = 0.0f;
-	float cur_dist = 0.0f;
-	float cur_angle = 0.0f;
-	float tar_vel = 0.0f;
-	float tar_dist = 0.0f;
-	float est_vel = 0.0f;  //estimated velocity
-	float preceding_truck_vel = 0.0f;
-
-	//TM = 0, RCM = 1, GDM = 2
-	uint8_t lrc_mode = 0;
-	uint8_t crc_mode = 0;
-
-	LaneCoef coef[3];
-}ZmqData;
+#include "clock_sync/clock_sync.hpp"
+#include "zmq_wire/zmq_wire.hpp"
+
+#define SEND_PERIOD 5  // milliseconds between telemetry sends per link
+#define SPIN_TIMEOUT 100  // milliseconds, longest reactor wait so controlDone_ is seen
+#define PEER_TIMEOUT 1000  // milliseconds without traffic before a peer is dropped
+#define BEACON_HEARTBEAT 50  // milliseconds, a beacon goes out at least this often
+#define BEACON_TIMEOUT 200  // milliseconds without a beacon before the sender is stale
+#define BEACON_RESYNC 1000  // backward seq jump taken as a restarted sender
+#define HEARTBEAT 100  // milliseconds, ZMTP ping on tcp links, a silent peer is dropped after 3
+#define RECONNECT_IVL 50  // milliseconds, first reconnect attempt after a disconnect
+#define RECONNECT_IVL_MAX 1000  // milliseconds, backoff limit
+#define SEND_LOG 512  // send times kept per link to match acks, two send periods of 256 ROUTER peers
+
+/* Peer of a ROUTER socket. DEALER peers get telemetry pushed every call,
+ * REQ peers (lockstep) one reply per request they sent. */
+typedef struct ZmqPeer{
+  std::string id;
+  uint8_t index = 255;  // src_index of its packets, the reply registered for it is sent
+  bool lockstep = false;
+  bool pending = false;
+  std::chrono::steady_clock::time_point last_seen;
+
+  //newest packet from the peer, acked on the next send, and the RTT it reports back
+  uint32_t rx_seq = 0;
+  bool rx_valid = false;
+  std::chrono::steady_clock::time_point rx_time;
+  float rtt = -1.0f;  // ms, smoothed
+  ClockSync::PeerClock clock;  // from the same acks
+}ZmqPeer;
+
+/* Health of one socket: connection events from its zmq_socket_monitor, RTT
+ * from acked packets. Written by the reactor thread */
+typedef struct LinkHealth{
+  const char* name = "";
+  bool enabled = false;
+  bool monitored = false;            // inproc:// has no monitor events
+  std::atomic<int> peers{0};         // live connections
+  std::atomic<uint32_t> connects{0};
+  std::atomic<uint32_t> disconnects{0};
+  std::atomic<uint32_t> retries{0};  // connect attempts that failed
+  std::atomic<uint32_t> handshake_fails{0};
+  std::atomic<float> rtt{-1.0f};     // ms, smoothed, < 0 = no sample yet
+  std::atomic<float> rtt_var{0.0f};  // ms, smoothed deviation
+  std::atomic<float> rtt_max{0.0f};  // ms, since the last healthReport
+  std::atomic<float> clock{NAN};     // ms, peer - local clock of a single peer link, NAN = unknown
+  std::atomic<float> skew{0.0f};     // ppm
+  int64_t sent[SEND_LOG] = {0,};     // steady ns, slot seq % SEND_LOG
+  int64_t sent_wall[SEND_LOG] = {0,};  // wall clock us, the send_stamp
+  uint32_t sent_seq[SEND_LOG] = {0,};
+
+  bool up() const { return !monitored || peers > 0; }
+}LinkHealth;
+
+namespace ZmqWire { struct Ack; }
+
+/* Multicast link health, written by the reactor thread */
+typedef struct BeaconStats{
+  std::atomic<uint32_t> sent{0};        // radio: beacons on the air
+  std::atomic<uint32_t> suppressed{0};  // radio: ticks with nothing new
+  std::atomic<uint32_t> received{0};    // dish: beacons applied
+  std::atomic<uint32_t> lost{0};        // dish: sequence gaps
+  std::atomic<uint32_t> late{0};        // dish: duplicate or out of order, dropped
+  std::atomic<uint32_t> timeouts{0};    // dish: times the sender went stale
+  std::atomic<int64_t> last_rx{0};      // dish: steady clock, ns
+  std::atomic<bool> stale{true};
+
+  float lossRate() const {
+    uint32_t total = received + lost;
+    return total ? (float)lost / total : 0.0f;
+  }
+  double ageMs() const {
+    if(last_rx == 0) return -1.0;
+    return (std::chrono::steady_clock::now().time_since_epoch().count() - last_rx) / 1e6;
+  }
+}BeaconStats;
 
 class ZMQ_CLASS{
 public:
-  ZMQ_CLASS();
+  explicit ZMQ_CLASS(const std::string& rep_endpoint = "");  // empty binds the default port
   ~ZMQ_CLASS();
-  
-  void* replyZMQ(ZmqData* send_data);
+
+  typedef std::function<void(ZmqData*)> DataFn;  // fill before a send, or handle a fresh packet
+  typedef std::function<void(bool)> StaleFn;  // called when the beacon sender goes stale (true) or comes back
+
+  /* Reactor. Register handlers for the enabled sockets, then spin() serves
+   * all of them from one thread: receives as soon as zmq_poll reports them,
+   * sends on per-link timers. Handlers run on the spinning thread. */
+  void onRequest(ZmqData* send_data, DataFn fill, DataFn recv);
+  void onReply(ZmqData* send_data, DataFn fill, DataFn recv);  // for the ROUTER peer whose src_index is send_data->tar_index
+  void onRadio(ZmqData* send_data, DataFn fill);
+  void onDish(DataFn recv, StaleFn stale = nullptr);
+  void addTimer(int period_ms, std::function<void()> fn);
+  void spin();
+
   std::string getIPAddress();
+  std::vector<std::string> healthReport();  // one line per socket and per ROUTER peer, reactor thread only
 
   std::string zipcode_;
   std::string rad_group_, dsh_group_;
-  std::string udp_ip_, tcpreq_ip_, tcprep_ip0_, tcprep_ip1_, tcprep_ip2_;
+  std::string udp_ip_, tcpreq_ip_, tcprep_ip_;
 
-  bool controlDone_;
-  bool rad_flag_, dsh_flag_, req_flag_, rep_flag0_, rep_flag1_, rep_flag2_;
-  ZmqData *rad_send_, *dsh_recv_, *req_send_, *req_recv_, *rep_send_, *rep_recv0_, *rep_recv1_, *rep_recv2_;
+  std::atomic<bool> controlDone_{false};
+  bool rad_flag_, dsh_flag_, req_flag_, rep_flag_;
+  ZmqData *dsh_recv_, *req_recv_, *rep_recv_;
+  std::atomic<uint32_t> wire_errors_{0};  // packets dropped by ZmqWire::decode
+  BeaconStats beacon_stats_;
   
 private:
+  typedef struct Reader{
+    void* socket;
+    std::function<void()> fn;
+  }Reader;
+
+  typedef struct Timer{
+    std::chrono::milliseconds period;
+    std::chrono::steady_clock::time_point next;
+    std::function<void()> fn;
+  }Timer;
+
+  //onReply registration, one per vehicle on the ROUTER
+  typedef struct Reply{
+    ZmqData* send_data;
+    DataFn fill;
+    DataFn recv;
+  }Reply;
+
   void init();
   bool readParameters();
-  void* requestZMQ(ZmqData *send_data);
-  void* radioZMQ(ZmqData *send_data);
-  void* dishZMQ();
+  void linkOptions(zmq::socket_t& socket);
+  void monitor(zmq::socket_t& socket, LinkHealth* link, const char* name, const std::string& endpoint);
+  void routerRecv();
+  void routerSend(bool lockstep_only);
+  size_t pack(ZmqData* send_data, uint8_t type, uint32_t* seq, uint8_t* buf, LinkHealth* link = nullptr, const ZmqPeer* peer = nullptr);
+  bool unpack(const zmq::message_t& frame, ZmqData* recv_data, uint32_t* seq = nullptr, ZmqWire::Ack* ack = nullptr);
+  bool trackBeacon(uint32_t seq);
+  bool recvPayload(zmq::socket_t& socket, ZmqData* recv_data, uint32_t* seq = nullptr, ZmqWire::Ack* ack = nullptr);
+  void received(LinkHealth* link, ZmqPeer* peer, uint32_t seq, const ZmqWire::Ack& ack, ZmqData* data);
+  void rttSample(LinkHealth* link, float rtt);
   
+  int send_period_, peer_timeout_, heartbeat_;
+  int beacon_heartbeat_, beacon_timeout_;
+  uint32_t req_seq_ = 0, rep_seq_ = 0, rad_seq_ = 0, dsh_seq_ = 0;
+  std::vector<uint8_t> rad_last_;  // last beacon on the air
+  std::chrono::steady_clock::time_point rad_sent_;
+  std::vector<ZmqPeer> rep_peers_;
+  std::vector<Reply> replies_;
+  int reply_slot_[256];  // src_index -> replies_, -1 = not registered
+  ZmqPeer req_server_;  // the DEALER's only peer
+  LinkHealth req_health_, rep_health_;
+  std::vector<Reader> readers_;
+  std::vector<Timer> timers_;
   std::string interface_name_;
-  zmq::socket_t rad_socket_, dsh_socket_, req_socket_, rep_socket0_, rep_socket1_, rep_socket2_;
+  zmq::socket_t rad_socket_, dsh_socket_, req_socket_, rep_socket_;
   zmq::context_t context_;
+  std::vector<std::unique_ptr<zmq::socket_t>> monitors_;
 };
@@ -1,12 +1,37 @@
+#include <errno.h>
+#include <algorithm>
 #include "includes/crc.hpp"
 
+static int usage(const char* name){
+	fprintf(stderr, "usage: %s [LRC index ...]\n", name);
+	fprintf(stderr, "  the platoon in order from the LV, 10 11 12 by default\n");
+	fprintf(stderr, "  each index once, 0..255 except 20 (control center) and 30 (CRC)\n");
+	return 1;
+}
+
+/* crc [LRC index ...], the platoon in order from the LV, 10 11 12 by default */
 int main(int argc, char *argv[]){
-	CentralResiliencyCoordinator::CentralRC CRC;
-	
-	gettimeofday(&CRC.launch_time_, NULL);
-	while(CRC.is_node_running_){
-		CRC.communicate();
+	std::vector<uint8_t> platoon;
+	for(int i = 1; i < argc; i++){
+		char* end;
+		errno = 0;
+		long index = strtol(argv[i], &end, 10);
+		if(end == argv[i] || *end != '\0' || errno == ERANGE || index < 0 || index > 255 || index == 20 || index == 30){
+			fprintf(stderr, "invalid LRC index '%s'\n", argv[i]);
+			return usage(argv[0]);
+		}
+		if(std::find(platoon.begin(), platoon.end(), index) != platoon.end()){
+			fprintf(stderr, "LRC index %ld given twice\n", index);
+			return usage(argv[0]);
+		}
+		platoon.push_back(index);
 	}
+	if(platoon.empty()) platoon = {10, 11, 12};
+
+	CentralResiliencyCoordinator::CentralRC CRC(platoon);
+
+	gettimeofday(&CRC.launch_time_, NULL);
+	CRC.run();
 
 	return 0;
 }
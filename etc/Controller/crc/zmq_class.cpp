@@ -1,6 +1,6 @@
 #include "includes/zmq_class.h"
 
-ZMQ_CLASS::ZMQ_CLASS()
+ZMQ_CLASS::ZMQ_CLASS(const std::string& rep_endpoint)
   :context_(1)	//zmq constructor dealing with the initialisation and termination of a zmq context
 {
   if(!readParameters())
@@ -8,6 +8,7 @@ ZMQ_CLASS::ZMQ_CLASS()
 	  perror("readParameters");
 	  exit(1);
   }
+  if(!rep_endpoint.empty()) tcprep_ip_ = rep_endpoint;
 
   init();
 }
@@ -17,16 +18,14 @@ ZMQ_CLASS::~ZMQ_CLASS()
   std::cout << "Disconnected" << std::endl;
   controlDone_ = true;
   req_socket_.close();
-  rep_socket0_.close();
-  rep_socket1_.close();
-  rep_socket2_.close();
+  rep_socket_.close();
   rad_socket_.close();
   dsh_socket_.close();
+  monitors_.clear();
 
   delete req_recv_;
-  delete rep_recv0_;
-  delete rep_recv1_;
-  delete rep_recv2_;
+  delete dsh_recv_;
+  delete rep_recv_;
 
   context_.close();
 }
@@ -37,36 +36,30 @@ void ZMQ_CLASS::init()
 
   /* Initialize zmq data */
   req_recv_ = new ZmqData;
-  rep_recv0_ = new ZmqData;
-  rep_recv1_ = new ZmqData;
-  rep_recv2_ = new ZmqData;
+  dsh_recv_ = new ZmqData;
+  rep_recv_ = new ZmqData;
+  std::fill(std::begin(reply_slot_), std::end(reply_slot_), -1);
 
-  /* Initialize Tcp client(Request) Socket */
+  /* Initialize Tcp client(Dealer) Socket, sends never wait for a reply */
   if(req_flag_)
   {
-    req_socket_ = zmq::socket_t(context_, ZMQ_REQ); 
-    req_socket_.connect(tcpreq_ip_);
-    req_socket_.setsockopt(ZMQ_RCVTIMEO, 10000);  //timeout (millisecends) 
+    req_socket_ = zmq::socket_t(context_, ZMQ_DEALER); 
+    req_socket_.setsockopt(ZMQ_SNDHWM, 2);  //keep only fresh telemetry queued
+    req_socket_.setsockopt(ZMQ_IMMEDIATE, 1);  //no queueing before the peer is up
     req_socket_.setsockopt(ZMQ_LINGER, 0); 
+    linkOptions(req_socket_);
+    monitor(req_socket_, &req_health_, "req", tcpreq_ip_);
+    req_socket_.connect(tcpreq_ip_);
   }
 
-  /* Initialize Tcp server(Reply) Socket */
-  if(rep_flag0_)
-  {
-    rep_socket0_ = zmq::socket_t(context_, ZMQ_REP);
-    rep_socket0_.bind(tcprep_ip0_);
-  }
-
-  if(rep_flag1_)
-  {
-    rep_socket1_ = zmq::socket_t(context_, ZMQ_REP);
-    rep_socket1_.bind(tcprep_ip1_);
-  }
-
-  if(rep_flag2_)
+  /* Initialize Tcp server(Router) Socket, every truck LRC connects to it */
+  if(rep_flag_)
   {
-    rep_socket2_ = zmq::socket_t(context_, ZMQ_REP);
-    rep_socket2_.bind(tcprep_ip2_);
+    rep_socket_ = zmq::socket_t(context_, ZMQ_ROUTER);
+    rep_socket_.setsockopt(ZMQ_LINGER, 0); 
+    linkOptions(rep_socket_);
+    monitor(rep_socket_, &rep_health_, "rep", tcprep_ip_);
+    rep_socket_.bind(tcprep_ip_);
   }
 
   /* Initialize Udp send(Radio) Socket */
@@ -83,9 +76,68 @@ void ZMQ_CLASS::init()
     dsh_socket_.bind(udp_ip_);
     dsh_socket_.join(dsh_group_.c_str());
   }
+}
+
+/* Fast reconnect, and ZMTP heartbeats so a dead peer is seen as a disconnect */
+void ZMQ_CLASS::linkOptions(zmq::socket_t& socket)
+{
+  socket.setsockopt(ZMQ_RECONNECT_IVL, RECONNECT_IVL);
+  socket.setsockopt(ZMQ_RECONNECT_IVL_MAX, RECONNECT_IVL_MAX);
+  socket.setsockopt(ZMQ_HEARTBEAT_IVL, heartbeat_);
+  socket.setsockopt(ZMQ_HEARTBEAT_TIMEOUT, heartbeat_ * 3);
+}
+
+/***********/
+/* Monitor */
+/***********/
+#ifdef ZMQ_EVENT_HANDSHAKE_FAILED_PROTOCOL
+#define HANDSHAKE_FAILED_EVENTS (ZMQ_EVENT_HANDSHAKE_FAILED_NO_DETAIL | ZMQ_EVENT_HANDSHAKE_FAILED_PROTOCOL | ZMQ_EVENT_HANDSHAKE_FAILED_AUTH)
+#else
+#define HANDSHAKE_FAILED_EVENTS 0
+#endif
+
+/* Connection events of one socket, read by the reactor like any other socket */
+void ZMQ_CLASS::monitor(zmq::socket_t& socket, LinkHealth* link, const char* name, const std::string& endpoint)
+{
+  link->name = name;
+  link->enabled = true;
+  link->monitored = (endpoint.compare(0, 9, "inproc://") != 0 && endpoint.compare(0, 6, "udp://") != 0);  //no connections to watch
+  if(!link->monitored) return;
+
+  std::string addr = (boost::format("inproc://monitor.%s.%p") % name % this).str();
+  int events = ZMQ_EVENT_CONNECTED | ZMQ_EVENT_ACCEPTED | ZMQ_EVENT_DISCONNECTED | ZMQ_EVENT_CONNECT_RETRIED | HANDSHAKE_FAILED_EVENTS;
+  if(zmq_socket_monitor(socket, addr.c_str(), events) != 0) {
+    printf("[ZMQ] %s monitor failed, link health unknown\n", name);
+    link->monitored = false;
+    return;
+  }
 
+  monitors_.emplace_back(new zmq::socket_t(context_, ZMQ_PAIR));
+  zmq::socket_t* mon = monitors_.back().get();
+  mon->connect(addr);
+  readers_.push_back({ *mon, [mon, link]() {
+    zmq::message_t event, addr_msg;
+    while(mon->recv(&event, ZMQ_DONTWAIT)) {
+      if(event.more()) mon->recv(&addr_msg, 0);
+      if(event.size() < 6) continue;
+      uint16_t id;
+      memcpy(&id, event.data(), sizeof(id));
+      if(id == ZMQ_EVENT_CONNECTED || id == ZMQ_EVENT_ACCEPTED) {
+        link->peers++;
+        link->connects++;
+      }
+      else if(id == ZMQ_EVENT_DISCONNECTED) {
+        if(link->peers > 0) link->peers--;
+        link->disconnects++;
+        printf("[ZMQ] %s peer disconnected\n", link->name);
+      }
+      else if(id == ZMQ_EVENT_CONNECT_RETRIED) link->retries++;
+      else if(id & HANDSHAKE_FAILED_EVENTS) link->handshake_fails++;
+    }
+  } });
 }
 
+
 std::string ZMQ_CLASS::getIPAddress(){
   std::string ipAddress="Unable to get IP Address";
   struct ifaddrs *interfaces = NULL;
@@ -113,7 +165,7 @@ std::string ZMQ_CLASS::getIPAddress(){
 
 bool ZMQ_CLASS::readParameters()
 {
-  std::string tcp_ip_server, tcp_ip_client, tcpreq_port, tcprep_port0, tcprep_port1, tcprep_port2;
+  std::string tcp_ip_server, tcp_ip_client, tcpreq_port, tcprep_port;
   std::string udp_ip, udp_port;
   interface_name_ = std::string("ens33");
 
@@ -121,9 +173,7 @@ bool ZMQ_CLASS::readParameters()
 //  tcp_ip_client = std::string("tcp://192.168.0.19");
 
   tcpreq_port = std::string("3333");
-  tcprep_port0 = std::string("4444");  //for LV
-  tcprep_port1 = std::string("5555");  //for FV1
-  tcprep_port2 = std::string("6666");  //for FV2
+  tcprep_port = std::string("4444");  //for every LRC
 
   zipcode_ = std::string("00011");
 
@@ -133,29 +183,25 @@ bool ZMQ_CLASS::readParameters()
   dsh_group_ = std::string("CRC");
   
   req_flag_ = false;
-  rep_flag0_ = true;
-  rep_flag1_ = true;
-  rep_flag2_ = true;
+  rep_flag_ = true;
   rad_flag_ = false;
   dsh_flag_ = false;
 
+  send_period_ = SEND_PERIOD;
+  peer_timeout_ = PEER_TIMEOUT;
+  heartbeat_ = HEARTBEAT;
+  beacon_heartbeat_ = BEACON_HEARTBEAT;
+  beacon_timeout_ = BEACON_TIMEOUT;
+
   //set request socket ip
   tcpreq_ip_ = tcp_ip_client;
   tcpreq_ip_.append(":");
   tcpreq_ip_.append(tcpreq_port);
 
   //set reply socket ip
-  tcprep_ip0_ = tcp_ip_server;
-  tcprep_ip0_.append(":");
-  tcprep_ip0_.append(tcprep_port0);
-
-  tcprep_ip1_ = tcp_ip_server;
-  tcprep_ip1_.append(":");
-  tcprep_ip1_.append(tcprep_port1);
-
-  tcprep_ip2_ = tcp_ip_server;
-  tcprep_ip2_.append(":");
-  tcprep_ip2_.append(tcprep_port2);
+  tcprep_ip_ = tcp_ip_server;
+  tcprep_ip_.append(":");
+  tcprep_ip_.append(tcprep_port);
 
   //set radio/dish socket ip
   udp_ip_ = udp_ip;
@@ -165,93 +211,358 @@ bool ZMQ_CLASS::readParameters()
   return true;
 }
 
-void* ZMQ_CLASS::requestZMQ(ZmqData* send_data)  // client: send -> recv
-{ 
-  if(req_socket_.connected() && !controlDone_)
+/* Stamps send_data and encodes it into buf, seq counts packets per link.
+ * With a link the send time is logged, with a peer its newest packet is acked */
+size_t ZMQ_CLASS::pack(ZmqData* send_data, uint8_t type, uint32_t* seq, uint8_t* buf, LinkHealth* link, const ZmqPeer* peer)
+{
+  auto now = std::chrono::steady_clock::now();
+  ZmqWire::Ack ack;
+  if(peer && peer->rx_valid) {
+    ack.seq = peer->rx_seq;
+    ack.delay_us = std::chrono::duration_cast<std::chrono::microseconds>(now - peer->rx_time).count();
+    ack.valid = true;
+  }
+  if(link) {
+    link->sent[*seq % SEND_LOG] = now.time_since_epoch().count();
+    link->sent_seq[*seq % SEND_LOG] = *seq;
+  }
+
+  gettimeofday(&send_data->send_stamp, NULL);
+  if(link) link->sent_wall[(*seq) % SEND_LOG] = ClockSync::PeerClock::toUs(send_data->send_stamp);
+  return ZmqWire::encode(*send_data, static_cast<ZmqWire::MsgType>(type), (*seq)++, buf, &ack);
+}
+
+/* Decodes one payload frame, recv_data is only written when it checks out */
+bool ZMQ_CLASS::unpack(const zmq::message_t& frame, ZmqData* recv_data, uint32_t* seq, ZmqWire::Ack* ack)
+{
+  if(ZmqWire::decode(frame.data(), frame.size(), recv_data, seq, ack)) return true;
+  wire_errors_++;
+  return false;
+}
+
+/* Reads the rest of a multipart message, the last frame is the payload */
+bool ZMQ_CLASS::recvPayload(zmq::socket_t& socket, ZmqData* recv_data, uint32_t* seq, ZmqWire::Ack* ack)
+{
+  zmq::message_t frame;
+  do {
+    socket.recv(&frame, 0);
+  } while(frame.more());
+
+  return unpack(frame, recv_data, seq, ack);
+}
+
+/***********/
+/* Reactor */
+/***********/
+void ZMQ_CLASS::addTimer(int period_ms, std::function<void()> fn)
+{
+  Timer timer;
+  timer.period = std::chrono::milliseconds(period_ms);
+  timer.next = std::chrono::steady_clock::now();
+  timer.fn = fn;
+  timers_.push_back(timer);
+}
+
+void ZMQ_CLASS::spin()
+{
+  std::vector<zmq::pollitem_t> items;
+  for(auto& reader : readers_) items.push_back({ reader.socket, 0, ZMQ_POLLIN, 0 });
+
+  while(!controlDone_)
   {
-    zmq::message_t recv_msg(DATASIZE), send_msg(DATASIZE);
+    //sleep until a socket is readable or the next timer is due
+    auto now = std::chrono::steady_clock::now();
+    long timeout = SPIN_TIMEOUT;
+    for(auto& timer : timers_) {
+      long due = std::chrono::duration_cast<std::chrono::milliseconds>(timer.next - now).count();
+      timeout = std::max(0L, std::min(timeout, due));
+    }
+    zmq::poll(items.data(), items.size(), timeout);
 
-    //send
-    memcpy(send_msg.data(), send_data, DATASIZE);
-    req_socket_.send(send_msg);
+    for(size_t i = 0; i < items.size(); i++) {
+      if(items[i].revents & ZMQ_POLLIN) readers_[i].fn();
+    }
 
-    //recv
-    req_socket_.recv(&recv_msg, 0);
-    memcpy(req_recv_, recv_msg.data(), DATASIZE);
-//    req_recv_ = static_cast<ZmqData *>(rep_msg.data());
+    now = std::chrono::steady_clock::now();
+    for(auto& timer : timers_) {
+      if(now < timer.next) continue;
+      timer.fn();
+      timer.next += timer.period;
+      if(timer.next < now) timer.next = now + timer.period;  //skip missed ticks, no bursts
+    }
   }
 }
 
-void* ZMQ_CLASS::replyZMQ(ZmqData* send_data)  //server: recv -> send
+/* Client: replies are handled as they arrive, sends run every send_period */
+void ZMQ_CLASS::onRequest(ZmqData* send_data, DataFn fill, DataFn recv)
+{
+  if(!req_flag_) return;
+
+  readers_.push_back({ req_socket_, [this, recv]() {
+    zmq::pollitem_t items[] = { { req_socket_, 0, ZMQ_POLLIN, 0 } };
+    do {
+      uint32_t seq;
+      ZmqWire::Ack ack;
+      if(recvPayload(req_socket_, req_recv_, &seq, &ack)) {
+        received(&req_health_, &req_server_, seq, ack, req_recv_);
+        recv(req_recv_);
+      }
+      zmq::poll(&items[0], 1, 0);
+    } while(items[0].revents & ZMQ_POLLIN);
+  } });
+
+  addTimer(send_period_, [this, send_data, fill]() {
+    uint8_t buf[ZmqWire::MAX_SIZE];
+    fill(send_data);
+    size_t size = pack(send_data, ZmqWire::MSG_TELEMETRY, &req_seq_, buf, &req_health_, &req_server_);
+    zmq::message_t send_msg(buf, size);
+    req_socket_.send(send_msg, ZMQ_DONTWAIT);  //dropped while the server is away
+  });
+}
+
+/* Server: one ROUTER for every vehicle, a peer is known by the src_index of its
+ * packets. REQ peers are answered right away, DEALER peers every send_period */
+void ZMQ_CLASS::onReply(ZmqData* send_data, DataFn fill, DataFn recv)
 {
-  zmq::message_t recv_msg(DATASIZE), send_msg(DATASIZE);
+  if(!rep_flag_) return;
 
-  if(send_data->tar_index == 10){  //LV LRC
-    if(rep_socket0_.connected() && !controlDone_)
-    {
-      //recv
-      rep_socket0_.recv(&recv_msg, 0);
-      memcpy(rep_recv0_, recv_msg.data(), DATASIZE);
-//      rep_recv0_ = static_cast<ZmqData *>(recv_msg.data()); 
-
-      //send
-      memcpy(send_msg.data(), send_data, DATASIZE);
-      rep_socket0_.send(send_msg);  
+  reply_slot_[send_data->tar_index] = replies_.size();
+  replies_.push_back({ send_data, fill, recv });
+  if(replies_.size() > 1) return;  //the reader and timer serve every registration
+
+  readers_.push_back({ rep_socket_, [this]() {
+    routerRecv();
+    routerSend(true);
+  } });
+
+  addTimer(send_period_, [this]() { routerSend(false); });
+}
+
+/* Beacons go out when the payload changes, and at least every beacon_heartbeat */
+void ZMQ_CLASS::onRadio(ZmqData* send_data, DataFn fill)
+{
+  if(!rad_flag_) return;
+
+  addTimer(send_period_, [this, send_data, fill]() {
+    uint8_t buf[ZmqWire::MAX_SIZE];
+    auto now = std::chrono::steady_clock::now();
+    uint32_t seq = rad_seq_;
+    fill(send_data);
+    size_t size = pack(send_data, ZmqWire::MSG_BEACON, &seq, buf);
+
+    bool changed = (size != rad_last_.size()) || !ZmqWire::samePayload(buf, rad_last_.data(), size);
+    if(!changed && now - rad_sent_ < std::chrono::milliseconds(beacon_heartbeat_)) {
+      beacon_stats_.suppressed++;
+      return;
     }
-  }
-  else if(send_data->tar_index == 11){  //FV1 LRC
-    if(rep_socket1_.connected() && !controlDone_)
-    {
-      //recv
-      rep_socket1_.recv(&recv_msg, 0);
-      memcpy(rep_recv1_, recv_msg.data(), DATASIZE);
-//      rep_recv1_ = static_cast<ZmqData *>(recv_msg.data()); 
-  
-      //send
-      memcpy(send_msg.data(), send_data, DATASIZE);
-      rep_socket1_.send(send_msg);  
+
+    zmq::message_t send_msg(buf, size);
+    send_msg.set_group(rad_group_.c_str());
+    if(rad_socket_.send(send_msg, ZMQ_DONTWAIT)) beacon_stats_.sent++;
+    rad_seq_ = seq;
+    rad_last_.assign(buf, buf + size);
+    rad_sent_ = now;
+  });
+}
+
+/* Beacons are applied in sequence order, the sender is stale after beacon_timeout */
+void ZMQ_CLASS::onDish(DataFn recv, StaleFn stale)
+{
+  if(!dsh_flag_) return;
+
+  readers_.push_back({ dsh_socket_, [this, recv, stale]() {
+    zmq::message_t recv_msg;
+    while(dsh_socket_.recv(&recv_msg, ZMQ_DONTWAIT)) {
+      ZmqData beacon;
+      uint32_t seq;
+      if(!unpack(recv_msg, &beacon, &seq) || !trackBeacon(seq)) continue;
+      if(beacon_stats_.stale.exchange(false)) {
+        printf("[ZMQ] beacon sender back\n");
+        if(stale) stale(false);
+      }
+      *dsh_recv_ = beacon;
+      recv(dsh_recv_);
     }
+  } });
+
+  addTimer(send_period_, [this, stale]() {
+    double age = beacon_stats_.ageMs();
+    if(beacon_stats_.stale || age < beacon_timeout_) return;  //stale from the start until the first beacon
+    beacon_stats_.stale = true;
+    beacon_stats_.timeouts++;
+    printf("[ZMQ] no beacon for %.0f ms, sender stale\n", age);
+    if(stale) stale(true);
+  });
+}
+
+/* Sequence check, late and duplicate beacons are dropped, gaps are counted as lost.
+ * After a timeout or a large backward jump (restarted sender) the count resyncs */
+bool ZMQ_CLASS::trackBeacon(uint32_t seq)
+{
+  int32_t gap = (int32_t)(seq - dsh_seq_);
+  bool synced = beacon_stats_.received > 0 && !beacon_stats_.stale;
+  if(synced && gap <= 0 && gap > -BEACON_RESYNC) {
+    beacon_stats_.late++;
+    return false;
   }
-  else if(send_data->tar_index == 12){  //FV2 LRC
-    if(rep_socket2_.connected() && !controlDone_)
-    {
-      //recv
-      rep_socket2_.recv(&recv_msg, 0);
-      memcpy(rep_recv2_, recv_msg.data(), DATASIZE);
-//      rep_recv2_ = static_cast<ZmqData *>(recv_msg.data()); 
-  
-      //send
-      memcpy(send_msg.data(), send_data, DATASIZE);
-      rep_socket2_.send(send_msg);  
+  if(synced && gap > 1) beacon_stats_.lost += gap - 1;
+
+  dsh_seq_ = seq;
+  beacon_stats_.received++;
+  beacon_stats_.last_rx = std::chrono::steady_clock::now().time_since_epoch().count();
+  return true;
+}
+
+/* Takes every queued message, [id][payload] from DEALER, [id][][payload] from REQ */
+void ZMQ_CLASS::routerRecv()
+{
+  auto now = std::chrono::steady_clock::now();
+  zmq::pollitem_t items[] = { { rep_socket_, 0, ZMQ_POLLIN, 0 } };
+  do {
+    zmq::message_t id, frame;
+    rep_socket_.recv(&id, 0);
+    if(id.more()) rep_socket_.recv(&frame, 0);
+
+    std::string peer_id(static_cast<char*>(id.data()), id.size());
+    bool lockstep = (frame.size() == 0 && frame.more());
+    bool valid = false;
+    uint32_t seq;
+    ZmqWire::Ack ack;
+    if(lockstep) valid = recvPayload(rep_socket_, rep_recv_, &seq, &ack);
+    else if(!frame.more()) valid = unpack(frame, rep_recv_, &seq, &ack);
+    else recvPayload(rep_socket_, rep_recv_);  //unknown envelope, drained
+
+    auto peer = std::find_if(rep_peers_.begin(), rep_peers_.end(), [&](const ZmqPeer& p) { return p.id == peer_id; });
+    if(peer == rep_peers_.end()) {
+      rep_peers_.push_back(ZmqPeer());
+      peer = rep_peers_.end() - 1;
+      peer->id = peer_id;
     }
-  }
+    peer->lockstep = lockstep;
+    peer->pending = true;
+    peer->last_seen = now;
+    if(valid) {
+      if(peer->index != rep_recv_->src_index) {
+        printf("[ZMQ] %s peer %u connected%s\n", lockstep ? "REQ" : "DEALER", rep_recv_->src_index,
+          reply_slot_[rep_recv_->src_index] < 0 ? ", not registered" : "");
+        peer->index = rep_recv_->src_index;
+      }
+      received(&rep_health_, &*peer, seq, ack, rep_recv_);
+      int slot = reply_slot_[peer->index];
+      if(slot >= 0) replies_[slot].recv(rep_recv_);
+    }
+
+    zmq::poll(&items[0], 1, 0);
+  } while(items[0].revents & ZMQ_POLLIN);
 }
 
-void* ZMQ_CLASS::radioZMQ(ZmqData *send_data)
+/* One message per live peer with its registered reply, quiet ones are dropped after peer_timeout */
+void ZMQ_CLASS::routerSend(bool lockstep_only)
 {
-  while(rad_socket_.connected() && !controlDone_)
+  auto now = std::chrono::steady_clock::now();
+  uint8_t buf[ZmqWire::MAX_SIZE];
+
+  for(auto peer = rep_peers_.begin(); peer != rep_peers_.end();)
   {
-    zmq::message_t pub_msg(DATASIZE);
-    pub_msg.set_group(rad_group_.c_str());
- 
-    //pub
-    memcpy(pub_msg.data(), send_data, DATASIZE);
-    rad_socket_.send(pub_msg, 0);
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    if(now - peer->last_seen > std::chrono::milliseconds(peer_timeout_)) {
+      printf("[ZMQ] peer %u silent for %d ms, dropped\n", peer->index, peer_timeout_);
+      peer = rep_peers_.erase(peer);
+      continue;
+    }
+    int slot = reply_slot_[peer->index];
+    if(slot >= 0 && (peer->lockstep ? peer->pending : !lockstep_only)) {
+      Reply& reply = replies_[slot];
+      reply.fill(reply.send_data);
+      size_t size = pack(reply.send_data, ZmqWire::MSG_TELEMETRY, &rep_seq_, buf, &rep_health_, &*peer);  //per peer, each gets its own ack
+      zmq::message_t id_msg(peer->id.data(), peer->id.size()), send_msg(buf, size);
+      rep_socket_.send(id_msg, ZMQ_SNDMORE | ZMQ_DONTWAIT);
+      if(peer->lockstep) {
+        zmq::message_t empty;
+        rep_socket_.send(empty, ZMQ_SNDMORE | ZMQ_DONTWAIT);
+      }
+      rep_socket_.send(send_msg, ZMQ_DONTWAIT);
+      peer->pending = false;
+    }
+    ++peer;
   }
 }
 
-void* ZMQ_CLASS::dishZMQ()
+/* Notes the newest packet from a peer. An ack in it closes an NTP exchange:
+ * t1 our send, t2 = t3 - ack delay, t3 its send_stamp, t4 now. That gives one
+ * RTT sample and one clock sample, data's stamps are then moved to our clock */
+void ZMQ_CLASS::received(LinkHealth* link, ZmqPeer* peer, uint32_t seq, const ZmqWire::Ack& ack, ZmqData* data)
 {
-  while(dsh_socket_.connected() && !controlDone_)
-  {
-    zmq::message_t sub_msg(DATASIZE);
+  auto now = std::chrono::steady_clock::now();
+  int64_t now_us = ClockSync::PeerClock::nowUs();
+  if(!peer->rx_valid || (int32_t)(seq - peer->rx_seq) > 0) {
+    peer->rx_seq = seq;
+    peer->rx_time = now;
+    peer->rx_valid = true;
+  }
+
+  int slot = ack.seq % SEND_LOG;
+  if(ack.valid && link->sent_seq[slot] == ack.seq && link->sent[slot] != 0) {
+    float rtt = (now.time_since_epoch().count() - link->sent[slot] - ack.delay_us * 1000LL) / 1e6f;
+    if(rtt < 0.0f) rtt = 0.0f;
+    peer->rtt = (peer->rtt < 0.0f) ? rtt : 0.875f * peer->rtt + 0.125f * rtt;
+    rttSample(link, rtt);
+
+    int64_t t3 = ClockSync::PeerClock::toUs(data->send_stamp);
+    peer->clock.addExchange(link->sent_wall[slot], t3 - ack.delay_us, t3, now_us);
+    if(peer == &req_server_) {
+      link->clock = peer->clock.offsetUs(now_us) / 1000.0;
+      link->skew = peer->clock.skewPpm();
+    }
+  }
 
-    //sub
-    dsh_socket_.recv(&sub_msg, 0);
-    dsh_recv_ = static_cast<ZmqData *>(sub_msg.data());
+  if(peer->clock.valid()) {
+    peer->clock.toLocal(&data->send_stamp);
+    peer->clock.toLocal(&data->image_stamp);
+    data->clock_synced = true;
+  }
+}
+
+/* Smoothed RTT and deviation, RFC 6298 gains */
+void ZMQ_CLASS::rttSample(LinkHealth* link, float rtt)
+{
+  float srtt = link->rtt;
+  if(srtt < 0.0f) {
+    link->rtt = rtt;
+    link->rtt_var = rtt / 2.0f;
+  }
+  else {
+    link->rtt_var = 0.75f * link->rtt_var + 0.25f * fabsf(srtt - rtt);
+    link->rtt = 0.875f * srtt + 0.125f * rtt;
+  }
+  if(rtt > link->rtt_max) link->rtt_max = rtt;
+}
+
+std::vector<std::string> ZMQ_CLASS::healthReport()
+{
+  std::vector<std::string> lines;
+  for(LinkHealth* link : { &req_health_, &rep_health_ }) {
+    if(!link->enabled) continue;
+    std::string line = (boost::format("ZMQ %-8s: ") % link->name).str();
+    if(!link->monitored) line += "unmonitored";
+    else line += (boost::format("%s %d, conn %u / disc %u / retry %u / hs fail %u")
+      % (link->up() ? "up" : "DOWN") % link->peers.load() % link->connects.load()
+      % link->disconnects.load() % link->retries.load() % link->handshake_fails.load()).str();
+    if(link->rtt >= 0.0f) {
+      line += (boost::format(", rtt %.2f +- %.2f ms (max %.2f)") % link->rtt.load() % link->rtt_var.load() % link->rtt_max.exchange(0.0f)).str();
+    }
+    if(!std::isnan(link->clock.load())) line += (boost::format(", clock %+.3f ms (%+.1f ppm)") % link->clock.load() % link->skew.load()).str();
+    lines.push_back(line);
+  }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  auto now = std::chrono::steady_clock::now();
+  for(const ZmqPeer& peer : rep_peers_) {
+    double seen = std::chrono::duration<double, std::milli>(now - peer.last_seen).count();
+    std::string line = (boost::format("ZMQ peer %-3u: %s, rtt %.2f ms, seen %.0f ms ago")
+      % (unsigned)peer.index % (peer.lockstep ? "REQ" : "DEALER") % peer.rtt % seen).str();
+    if(peer.clock.valid()) {
+      line += (boost::format(", clock %+.3f ms (%+.1f ppm)") % (peer.clock.offsetUs(ClockSync::PeerClock::nowUs()) / 1000.0) % peer.clock.skewPpm()).str();
+    }
+    lines.push_back(line);
   }
+  return lines;
 }
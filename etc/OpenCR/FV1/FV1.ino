@@ -50,6 +50,8 @@ float tx_dist_;
 float tx_tdist_;
 float est_vel_;
 float preceding_truck_vel_;
+ros::Time image_stamp_;  // stamps of the running command, echoed to the LRC
+ros::Time cmd_stamp_;
 float output_;
 float u_k_;
 volatile int EN_pos_;
@@ -75,6 +77,8 @@ void LrcCallback(const scale_truck_control::lrc2ocr &msg) {
   preceding_truck_vel_ = msg.preceding_truck_vel;
   fi_encoder_ = msg.fi_encoder;
   Alpha_ = msg.alpha;
+  image_stamp_ = msg.image_stamp;
+  cmd_stamp_ = msg.lrc_stamp;
 }
 /*
    SPEED to RPM
@@ -101,6 +105,8 @@ float setSPEED(float tar_vel, float current_vel) {
   float ref_vel = 0.f, cur_vel = 0.f;
   cur_vel = current_vel;
   pub_msg_.cur_vel = cur_vel;
+  pub_msg_.image_stamp = image_stamp_;
+  pub_msg_.cmd_stamp = cmd_stamp_;
   //if(fi_encoder_) cur_vel = 0;
   if(Alpha_){
     Kp_dist_ = 0.33; //0.46
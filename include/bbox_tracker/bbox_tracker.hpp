@@ -0,0 +1,38 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <ros/ros.h>
+
+namespace BboxTracker {
+
+/* Follows the YOLO box of the preceding truck between detections by
+ * normalized template matching in a window around the last position */
+class Tracker{
+public:
+	explicit Tracker(ros::NodeHandle nh);
+
+	void init(const cv::Mat& frame, const cv::Rect& box);  // fresh YOLO detection
+	bool update(const cv::Mat& frame, cv::Rect* box);      // false when the match is lost
+	void reset();
+
+	bool needDetection() const;  // YOLO should run on the next frames
+	float confidence() const { return confidence_; }
+	int framesSinceDetection() const { return since_; }
+
+private:
+	cv::Mat prepare(const cv::Mat& frame, const cv::Rect& roi) const;
+
+	ros::NodeHandle nodeHandle_;
+	int search_margin_;     // px around the last box
+	float min_confidence_;  // TM_CCOEFF_NORMED score
+	int redetect_frames_;   // frames between forced detections
+	double scale_;          // matching resolution
+
+	cv::Mat templ_;
+	cv::Rect box_;
+	float confidence_ = 0.0f;
+	int since_ = 0;
+	bool valid_ = false;
+};
+
+}
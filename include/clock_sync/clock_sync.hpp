@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/time.h>
+
+namespace ClockSync {
+
+#define CLOCK_FILTER 8            // exchanges the minimum delay one is picked from
+#define CLOCK_WINDOW 64           // filtered samples the skew is fitted over
+#define CLOCK_SKEW_SPAN 10.0      // seconds of samples needed before a skew is fitted
+#define CLOCK_SKEW_MAX 500.0      // ppm, crystal drift beyond this is taken as noise
+#define CLOCK_STEP 50000.0        // us, this far off the fit is a clock step
+#define CLOCK_STEP_COUNT 3        // filtered samples in a row off the fit before a reset
+#define CLOCK_DELAY_SLACK 2000.0  // us, kept samples are within twice the window's best delay plus this
+
+typedef struct ClockSample{
+	int64_t local = 0;   // us, our clock when the exchange finished
+	double offset = 0.0; // us, peer - local
+	double delay = 0.0;  // us, round trip without the peer's hold time
+}ClockSample;
+
+/* NTP style estimate of a peer clock against ours, from the four stamps of
+ * request/reply exchanges that already happen. Of the last CLOCK_FILTER
+ * exchanges the one with the smallest delay (least queueing, so least
+ * asymmetry) is kept, unless even that one queued far longer than the best
+ * in the window. Offset and skew are a line fitted over the kept ones */
+class PeerClock{
+public:
+	/* t1 our send, t2 peer receive, t3 peer send, t4 our receive, wall clock us */
+	void addExchange(int64_t t1, int64_t t2, int64_t t3, int64_t t4);
+	void reset();
+
+	bool valid() const { return fitted_; }
+	double offsetUs(int64_t local_us) const;  // peer - local at our time local_us
+	double skewPpm() const { return skew_ * 1e6; }
+	double delayUs() const { return delay_; }
+
+	/* peer stamp -> our clock, untouched while not valid or unstamped */
+	void toLocal(struct timeval* stamp) const;
+
+	static int64_t nowUs();
+	static int64_t toUs(const struct timeval& tv);
+
+private:
+	void fit();
+	double minDelay() const;
+
+	ClockSample raw_[CLOCK_FILTER];
+	int raw_count_ = 0;
+	int raw_next_ = 0;
+	int64_t last_kept_ = 0;
+
+	ClockSample kept_[CLOCK_WINDOW];
+	int kept_count_ = 0;
+	int kept_next_ = 0;
+	int off_fit_ = 0;
+	int slow_ = 0;
+
+	bool fitted_ = false;
+	int64_t ref_ = 0;      // us, local time the fit is anchored at
+	double offset_ = 0.0;  // us, peer - local at ref_
+	double skew_ = 0.0;    // peer clock rate - 1
+	double delay_ = 0.0;
+};
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cmath>
+#include <mutex>
+#include <ros/ros.h>
+
+namespace DistFusion {
+
+#define FUSION_BUFFER 8
+
+enum Sensor { LIDAR = 0, CAMERA = 1, SENSORS = 2 };
+
+typedef struct Sample{
+	ros::Time stamp;  // sensor time of the measurement
+	float dist = 0.0f;
+}Sample;
+
+/* Last FUSION_BUFFER measurements of one sensor, read back at any time */
+class MeasurementBuffer{
+public:
+	void push(const ros::Time& stamp, float dist);
+	void clear();
+	/* interpolates inside the buffer, extrapolates at most horizon past the newest sample */
+	bool at(const ros::Time& t, double horizon, float* dist, double* age) const;
+
+private:
+	Sample samples_[FUSION_BUFFER];
+	int head_ = 0;   // next slot
+	int count_ = 0;
+};
+
+typedef struct Result{
+	float dist = 10.1f;
+	float weight[SENSORS] = {0.0f, 0.0f};  // normalized
+	double age[SENSORS] = {0.0, 0.0};      // s, control time - newest sample
+	bool valid = false;
+}Result;
+
+/* Inverse variance fusion of the lidar and camera gap at a common control time.
+ * Variance grows with measurement age, weights are scaled by a health value that
+ * ramps toward the sensor state, so a failing sensor fades out instead of jumping */
+class DistanceFusion{
+public:
+	explicit DistanceFusion(ros::NodeHandle nh);
+
+	void push(Sensor sensor, const ros::Time& stamp, float dist);
+	void setHealthy(Sensor sensor, bool healthy);
+	Result fuse(const ros::Time& t);
+	float health(Sensor sensor);
+
+private:
+	ros::NodeHandle nodeHandle_;
+	float sigma_[SENSORS];  // m, fresh measurement
+	float drift_;           // m/s, sigma growth with age
+	double max_age_;        // s, older sensors are ignored
+	double horizon_;        // s, extrapolation limit
+	double health_tau_;     // s
+
+	MeasurementBuffer buffer_[SENSORS];
+	bool healthy_[SENSORS] = {false, false};
+	float health_[SENSORS] = {0.0f, 0.0f};
+	ros::Time last_fuse_;
+	float last_dist_ = 10.1f;
+	std::mutex mutex_;
+};
+
+}
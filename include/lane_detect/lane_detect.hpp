@@ -22,6 +22,30 @@ using namespace std;
 
 namespace LaneDetect {
 
+/* Sliding window geometry resolved at compile time for a fixed camera format */
+template <int W, int H>
+struct LaneGeometry {
+	static constexpr int width = W;
+	static constexpr int height = H;
+	static constexpr int n_windows = 9;
+	static constexpr int margin = 120 * W / 1280;
+	static constexpr int min_pix = 30 * W / 1280;
+	static constexpr int window_width = margin * 2;
+};
+
+/* 640x480 on all trucks, other ROI sizes take the generic path */
+typedef LaneGeometry<640, 480> CameraGeometry;
+
+/* QoS degradation steps, each level keeps the ones below it */
+enum QosLevel {
+	QOS_FULL = 0,
+	QOS_NO_DRAW,       // no OpenCV windows
+	QOS_REDUCED_RATE,  // estimatePose (and the rear JPEG) every other frame
+	QOS_HALF_RES,      // threshold and window search at half resolution
+	QOS_TRACK_ONLY,    // windows start from the last lane bases, no histogram
+	QOS_LEVELS
+};
+
 class LaneDetector{
 public:
 	LaneDetector(ros::NodeHandle nh);
@@ -35,6 +59,7 @@ public:
 	float K1_, K2_, K3_, K4_;
 	int distance_ = 0;
 	float est_dist_ = 0.0f;
+	uint32_t est_seq_ = 0;  // bumped with every new est_dist_
 	float est_pose_ = 0.0f;
 	scale_truck_control::lane_coef lane_coef_;
 	Mat frame_;
@@ -55,11 +80,17 @@ public:
 	/***** fault signal *****/
 	bool beta_ = false, gamma_ = false;
 
+	/***** QoS *****/
+	int qos_level_ = QOS_FULL;
+
 private:
 	void LoadParams(void);
 	int arrMaxIdx(int hist[], int start, int end, int Max);
-	Mat polyfit(vector<int> x_val, vector<int> y_val);
+	Mat polyfit(const vector<int>& x_val, const vector<int>& y_val);
 	Mat detect_lines_sliding_window(Mat _frame, bool _view);
+	template <int W, int H>
+	Mat detect_lines_sliding_window_fixed(const Mat& _frame, bool _view);
+	void fit_lanes(int rows);
 	Point warpPoint(Point center, Mat trans);
 	float lowPassFilter(double sampling_time, float est_value, float prev_res);
 	Mat estimateDistance(Mat frame, Mat trans, double cycle_time, bool _view);
@@ -80,8 +111,9 @@ private:
 	vector<Point2f> warpCorners_, fROIwarpCorners_, rROIwarpCorners_;
 	float wide_extra_upside_[2], wide_extra_downside_[2];
 
-	int last_Llane_base_;
+	int last_Llane_base_;  // bottom window of the last frame, full resolution x
 	int last_Rlane_base_;
+	unsigned int qos_frame_ = 0;
 
 	vector<int> left_lane_inds_;
 	vector<int> right_lane_inds_;
@@ -117,6 +149,8 @@ private:
 	double diff_;
 
 	int crop_x_, crop_y_, crop_width_, crop_height_;
+
+	Mat sliding_result_;
 };
 
 }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <string>
+#include <mutex>
+
+namespace Latency {
+
+#define LATENCY_BINS 10
+
+/* Age histogram for one hop of the camera -> OpenCR chain (ms) */
+class LatencyHistogram{
+public:
+	explicit LatencyHistogram(const std::string& name);
+
+	void record(double age_ms);
+	void record(const struct timeval& stamp);  // age against the local clock
+	void reset();
+	double mean();
+	double max();
+	double percentile(double p);  // upper bound of the bin holding p
+	std::string summary();
+
+	static double ageMs(const struct timeval& stamp);
+	static const double bounds_[LATENCY_BINS - 1];
+
+private:
+	std::string name_;
+	uint32_t bins_[LATENCY_BINS] = {0,};
+	uint32_t count_ = 0;
+	double sum_ = 0.0;
+	double max_ = 0.0;
+	std::mutex mutex_;
+};
+
+}
@@ -10,8 +10,12 @@
 #include <fstream>
 #include <sys/time.h>
 #include <string>
+#include <memory>
 
 #include "zmq_class/zmq_class.h"
+#include "latency/latency.hpp"
+#include "rt_util/rt_util.hpp"
+#include "stats_shm/stats_shm.hpp"
 
 #include <scale_truck_control/xav2lrc.h>
 #include <scale_truck_control/ocr2lrc.h>
@@ -40,6 +44,7 @@ class LocalRC{
 
     int index_;
     ZmqData* lrc_data_;
+    ZmqData beacon_data_;  // LV multicast, tar_vel / tar_dist only
     uint8_t lrc_mode_;
     uint8_t crc_mode_;
 
@@ -48,17 +53,18 @@ class LocalRC{
     void XavCallback(const scale_truck_control::xav2lrc &msg);
     void OcrCallback(const scale_truck_control::ocr2lrc &msg);
     void rosPub();
-    void radio(ZmqData* zmq_data);
-    void dish();
-    void request(ZmqData* zmq_data);
+    void communicateZMQ(ZmqData* zmq_data);
+    void leaderStale(bool stale);
     void encoderCheck();
     void updateMode(uint8_t crc_mode);
     void updateData(ZmqData* zmq_data);
     void recordData(struct timeval *startTime);
-    void printStatus();
+    void updateStats();
 
     bool is_node_running_;
-    bool EnableConsoleOutput_;
+    bool EnableConsoleOutput_;  // publish the stats page for stc_top
+    std::unique_ptr<StatsShm::StatsWriter> stats_;
+    int stats_cnt_ = 0;
     std::string log_path_;
     float a_, b_, l_;
     float epsilon_;
@@ -70,12 +76,15 @@ class LocalRC{
     bool alpha_ = false;
     bool beta_ = false;
     bool gamma_ = false;
+    uint8_t qos_level_ = 0;  // STC lateral QoS step, 0 = full vision
     bool send_rear_camera_image_ = false;
+    bool leader_stale_ = false;  // FVs, no LV beacon within beacon_timeout_ms
 
     float rcm_vel_ = 0;
     float rcm_dist_ = 0;
     float angle_degree_ = 0;
     float cur_dist_ = 0.8f;
+    float rel_vel_ = 0;  // gap rate from the STC tracker
     float tar_dist_ = 0.8f;
     float ref_vel_ = 0;
     float cur_vel_ = 0;
@@ -87,9 +96,25 @@ class LocalRC{
     double time_ = 0;
     double req_time_ = 0;
 
+    //latency stamps forwarded to the OpenCR
+    ros::Time image_stamp_;
+    ros::Time scan_stamp_;
+    ros::Time stc_stamp_;
+    Latency::LatencyHistogram stcAge_{"stc->lrc"};
+    Latency::LatencyHistogram ocrRtt_{"lrc->ocr->lrc"};
+    Latency::LatencyHistogram glassToWheel_{"camera->ocr"};
+    Latency::LatencyHistogram zmqAge_{"zmq"};
+
+    //RT mode, core < 0 = not pinned, priority used only when rt_enable_
+    bool rt_enable_;
+    bool rt_lock_memory_;
+    double cycle_budget_;
+    int lrc_core_, zmq_core_;
+    int lrc_prio_, zmq_prio_;
+    RTUtil::DeadlineMonitor cycleMonitor_{"lrc"};
+
     std::thread lrcThread_;
-    std::thread udpThread_;
-    std::thread tcpThread_;
+    std::thread zmqThread_;  // all LRC sockets, ZMQ_CLASS::spin
     std::mutex data_mutex_;
     std::mutex time_mutex_;
 };
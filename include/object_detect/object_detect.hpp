@@ -1,21 +1,50 @@
 #pragma once
 
 //ROS
-#include <sensor_msgs/LaserScan>
+#include <sensor_msgs/LaserScan.h>
+#include <obstacle_detector/Obstacles.h>
 #include <ros/ros.h>
 
 //C++
 #include <iostream>
+#include <vector>
+#include <cmath>
 
 namespace object_detect {
 
+/* Forward sector of the raw scan -> clusters -> one circle per truck rear.
+ * Circles follow the obstacle_extractor convention used by the controller:
+ * gap = -center.x - true_radius, lateral offset = center.y */
 class ObjectDetector{
   public:
     ObjectDetector(ros::NodeHandle nh);
     ~ObjectDetector(void);
+
+    obstacle_detector::Obstacles::ConstPtr detect(const sensor_msgs::LaserScan::ConstPtr& scan);
+
   private:
-    void scanCallback(const sensor_msgs::LaserScan::ConstPtr& scan);
+    void LoadParams(void);
+    void updateSector(const sensor_msgs::LaserScan& scan);
+    bool fitRear(size_t begin, size_t end, obstacle_detector::CircleObstacle* circle);
+
+    ros::NodeHandle nodeHandle_;
+
+    /********** Params **********/
+    float fov_;                 // rad, full width of the forward sector
+    float min_range_, max_range_;
+    float cluster_gap_;         // m between neighbouring points of one cluster
+    float cluster_proportion_;  // gap growth per m of range
+    int min_points_;
+    float depth_tolerance_;     // m behind the nearest point still counted as the rear face
+
+    /********** Sector geometry, rebuilt when the scan layout changes **********/
+    float angle_min_ = 0.0f, angle_increment_ = 0.0f;
+    size_t scan_size_ = 0;
+    std::vector<int> index_;    // scan indices in angular order across +-pi
+    std::vector<float> cos_, sin_;
 
+    /********** Per scan buffers **********/
+    std::vector<float> range_, x_, y_;
 };
 
 }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace QoS {
+
+/* Steps a degradation level up while cycles overrun the budget and back
+ * down once the averaged cycle time leaves enough headroom (hysteresis) */
+class Scheduler{
+public:
+	explicit Scheduler(const std::string& name);
+
+	void configure(double budget_ms, int max_level, double degrade_ratio, double recover_ratio, int degrade_cycles, int recover_cycles);
+	int update(double cycle_ms);  // returns the level for the next cycle
+	int level() const { return level_; }
+	double average() const { return avg_; }
+
+private:
+	std::string name_;
+	double budget_ = 0.0;
+	int max_level_ = 0;
+	double degrade_ratio_ = 1.0;  // cycle > budget * ratio counts as overrun
+	double recover_ratio_ = 0.6;  // average < budget * ratio counts as headroom
+	int degrade_cycles_ = 3;
+	int recover_cycles_ = 30;
+
+	double avg_ = 0.0;
+	int over_ = 0;
+	int under_ = 0;
+	int level_ = 0;
+};
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <thread>
+#include <string>
+
+#include "seqlock/seqlock.hpp"
+
+namespace RTUtil {
+
+/* core < 0 leaves the affinity alone, priority <= 0 keeps SCHED_OTHER */
+bool setThreadAttr(std::thread& thread, int core, int priority, const char* name);
+bool setThreadAttr(pthread_t thread, int core, int priority, const char* name);
+
+/* mlockall and touch stack_bytes of stack so the first cycles do not fault */
+bool lockMemory(size_t stack_bytes);
+
+/* Counters of one DeadlineMonitor, plain data so they fit a Seqlock */
+struct DeadlineStats{
+	double budget = 0.0;
+	uint32_t cycles = 0;
+	uint32_t misses = 0;
+	double exec_max = 0.0;
+	double exec_sum = 0.0;
+	uint32_t periods = 0;
+	double period_sum = 0.0;
+	double period_sq_sum = 0.0;
+	double period_min = 0.0;
+	double period_max = 0.0;
+};
+
+/* Cycle time and period jitter of one loop against a budget (ms).
+ * begin()/end() belong to the loop thread, the readers get the snapshot
+ * published at the end of each cycle */
+class DeadlineMonitor{
+public:
+	explicit DeadlineMonitor(const std::string& name, double budget_ms = 0.0);
+
+	void setBudget(double budget_ms);
+	void begin();
+	void end();
+	void reset();
+	uint32_t misses() const { return snapshot_.load().misses; }
+	double jitter() const;  // std dev of the period
+	std::string summary() const;
+
+private:
+	static double nowMs();
+	static double jitter(const DeadlineStats& stats);
+
+	std::string name_;
+	double begin_ = 0.0;
+	double prev_begin_ = 0.0;
+	DeadlineStats stats_;  // loop thread only
+	scale_truck_control::Seqlock<DeadlineStats> snapshot_;
+};
+
+}
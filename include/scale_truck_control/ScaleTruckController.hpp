@@ -19,6 +19,8 @@
 #include <sys/time.h>
 #include <string>
 #include <condition_variable>
+#include <atomic>
+#include <memory>
 
 //ROS
 #include <geometry_msgs/Twist.h>
@@ -26,6 +28,7 @@
 #include <std_msgs/Float32.h>
 #include <std_msgs/UInt32.h>
 #include <sensor_msgs/Image.h>
+#include <sensor_msgs/LaserScan.h>
 #include <sensor_msgs/image_encodings.h>
 #include <obstacle_detector/Obstacles.h>
 #include <image_transport/image_transport.h>
@@ -35,7 +38,17 @@
 #include <opencv2/imgcodecs.hpp>
 
 #include "lane_detect/lane_detect.hpp"
+#include "object_detect/object_detect.hpp"
 #include "zmq_class/zmq_class.h"
+#include "triple_buffer/triple_buffer.hpp"
+#include "seqlock/seqlock.hpp"
+#include "latency/latency.hpp"
+#include "rt_util/rt_util.hpp"
+#include "stats_shm/stats_shm.hpp"
+#include "vehicle_tracker/vehicle_tracker.hpp"
+#include "dist_fusion/dist_fusion.hpp"
+#include "bbox_tracker/bbox_tracker.hpp"
+#include "qos/qos.hpp"
 
 #include <pcl_ros/point_cloud.h>
 #include <sensor_msgs/PointCloud.h>
@@ -48,6 +61,69 @@
 
 namespace scale_truck_control {
 
+typedef struct CameraFrame{
+  cv_bridge::CvImageConstPtr image;  // keeps the shared ROS buffer alive
+  uint32_t seq = 0;
+}CameraFrame;
+
+/* Commands from LRC / CRC */
+typedef struct CommandState{
+  float tar_vel = 0.0f;
+  float tar_dist = 0.8f;
+  float cc_vel = 0.0f;   // last control center command (LV)
+  float cc_dist = 0.8f;
+  float cur_vel = 0.0f;
+  bool fi_encoder = false;
+  bool fi_camera = false;
+  bool fi_lidar = false;
+  bool alpha = false;
+  bool send_rear_camera_image = false;
+  uint8_t lrc_mode = 0;
+  uint8_t crc_mode = 0;
+}CommandState;
+
+/* Control outputs and fault flags */
+typedef struct ControlState{
+  float angle_degree = 0.0f;
+  float result_vel = 0.0f;
+  float distance = 10.0f;
+  bool dist_valid = true;    // false: no sensor has a current gap, distance is the last known one
+  float dist_angle = 0.0f;
+  float act_dist = 0.8f;
+  float est_dist = 0.8f;
+  float x_coord = 0.0f;
+  float y_coord = 0.0f;
+  int obj_circles = 0;
+  float rel_vel = 0.0f;      // preceding truck range rate, > 0 = gap opening
+  bool tracked = false;      // distance comes from a confirmed track
+  float lidar_weight = 0.0f; // share of the lidar in the fused distance
+  ros::Time scan_stamp;      // scan the distance was measured on
+  ros::Time distance_stamp;  // time the distance was predicted to
+  bool beta = false;
+  bool gamma = false;
+}ControlState;
+
+/* Lane detector results, published after display_img */
+typedef struct LaneState{
+  LaneCoef coef[3];  // left, right, center
+  float y_offset = 0.0f;
+  float est_dist = 0.0f;
+  float K1 = 0.0f;
+  float K2 = 0.0f;
+  float box_conf = 0.0f;  // bbox tracker match score
+  int box_frames = 0;     // frames since the last YOLO box
+  ros::Time image_stamp;  // frame the coefficients came from
+}LaneState;
+
+typedef struct BboxState{
+  char name[16] = {0,};
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t w = 0;
+  uint32_t h = 0;
+  uint32_t seq = 0;  // bumped per accepted YOLO box
+}BboxState;
+
 class ScaleTruckController {
   public:
     explicit ScaleTruckController(ros::NodeHandle nh);
@@ -61,18 +137,30 @@ class ScaleTruckController {
 
     void imageCallback(const sensor_msgs::ImageConstPtr &msg);
     void rearImageCallback(const sensor_msgs::ImageConstPtr &msg);
-    void objectCallback(const obstacle_detector::Obstacles &msg);
+    void objectCallback(const obstacle_detector::Obstacles::ConstPtr &msg);
+    void scanCallback(const sensor_msgs::LaserScan::ConstPtr &msg);
     void XavSubCallback(const scale_truck_control::lrc2xav &msg);
     void ScanErrorCallback(const std_msgs::UInt32::ConstPtr &msg);
     void bboxCallback(const yolo_object_detection::bounding_box &msg);
     void recordData(struct timeval startTime);
     void imageCompress(cv::Mat camImage, std::vector<uchar> *compImage);
     void reply(ZmqData* zmq_data);
+    void applyCommand(ZmqData* zmq_data);
+    void applyCrcMode(CommandState& cmd);
+    void encodeRearImage();
     void requestImage(ImgData* img_data);
-    void replyImage(); 
-    void displayConsole();
+    void replyImage(ImgData* img_data);
+    void decodeRearImage();
+    void decodeImage(const std::vector<uchar>& jpeg, ImgData* img_data);
+    void updateStats();
+    scale_truck_control::xav2lrc xavMessage();
     void spin();
     bool getImageStatus(void);
+    bool waitForImage();
+    void lateralLoop();
+    void trackBox(const cv::Mat& frame, BboxState* box);
+    void requestYolo(bool run);
+    void longitudinalLoop();
 
     void clusterCallback(const sensor_msgs::PointCloud &msg);
     ros::Subscriber clusterSubscriber_;
@@ -83,6 +171,7 @@ class ScaleTruckController {
     ros::Subscriber imageSubscriber_;
     ros::Subscriber rearImageSubscriber_;
     ros::Subscriber objectSubscriber_;
+    ros::Subscriber scanSubscriber_;
     ros::Subscriber XavSubscriber_;
     ros::Subscriber ScanSubError;	
     ros::Subscriber bboxSubscriber_;	
@@ -96,33 +185,32 @@ class ScaleTruckController {
     int index_;
     float RCMVel_;
     float RCMDist_;
-    bool fi_encoder_ = false;
-    bool alpha_ = false;
-    bool send_rear_camera_image_ = false;
-    uint8_t lrc_mode_ = 0;
-    uint8_t crc_mode_ = 0;
 
     //image
     LaneDetect::LaneDetector laneDetector_;
     bool viewImage_;
     bool rear_camera_;
     int waitKeyDelay_;
-    bool enableConsoleOutput_;
+    bool enableConsoleOutput_;  // publish the stats page for stc_top
+    std::unique_ptr<StatsShm::StatsWriter> stats_;
     int sync_flag_;
-    bool fi_camera_ = false;
-    bool beta_ = false;
 
-    float AngleDegree_; // -1 ~ 1  - Twist msg angular.z
     float TargetVel_ = 0.0f; // -1 ~ 1  - Twist msg linear.x
     float SafetyVel_;
-    float ResultVel_;
     float FVmaxVel_;
 
     //object
+    object_detect::ObjectDetector objectDetector_;
+    bool objectDetectEnable_;  // raw LaserScan in process instead of obstacle_extractor
+    VehicleTracker::Tracker tracker_;  // longitudinal loop only
+    obstacle_detector::Obstacles::ConstPtr trackedScan_;
+    DistFusion::DistanceFusion distFusion_;  // lidar pushed by the longitudinal loop, camera by the lateral loop
+    uint32_t estSeq_ = 0;
+    BboxTracker::Tracker bboxTracker_;  // lateral loop only
+    bool bboxTrackerEnable_;
+    uint32_t bboxSeq_ = 0;  // newest YOLO box the tracker was seeded from
+    bool bboxTracking_ = false;  // gamma with the tracker, boxes from before it are stale
     int ObjSegments_;
-    int ObjCircles_;
-    float distance_ = 0.8f;
-    float distAngle_ = 0.0f;
     float ampersand_ = 0.0f;
     float ampersand2_ = 0.0f;
     float LVstopDist_;
@@ -130,32 +218,37 @@ class ScaleTruckController {
     float TargetDist_;
     float SafetyDist_;
     uint32_t LdrErrMsg_;
-    bool fi_lidar_ = false;
-    bool gamma_ = false;
-    float log_est_dist_ = 0.0f;
-    float AngleDegree2_ = 0.0f;
-    float actAngleDegree_ = 0.0f;
     float Lw_ = 0.34f;
     float Ld_offset_ = 0.0f;
     float Ld_offset2_ = 0.0f;
-    float actDist_ = 0.8f;
-    float estimatedDist_;
     float ppAngle_ = 0.0f;
-    float x_coord_ = 0.0f;
-    float y_coord_ = 0.0f;
-
-    //bbox
-    std::string name_;
-    uint32_t x_ = 0;
-    uint32_t y_ = 0;
-    uint32_t w_ = 0;
-    uint32_t h_ = 0;
+
+    //Shared state, readers take a snapshot and never block the writers
+    Seqlock<CommandState> commandState_;
+    Seqlock<ControlState> controlState_;
+    Seqlock<LaneState> laneState_;
+    Seqlock<BboxState> bboxState_;
+
+    //Latency, age of the source stamp at each hop
+    Latency::LatencyHistogram cameraAge_{"camera->stc"};
+    Latency::LatencyHistogram scanAge_{"scan->stc"};
+    Latency::LatencyHistogram laneAge_{"camera->lane"};
+    Latency::LatencyHistogram cmdAge_{"camera->cmd"};
+    Latency::LatencyHistogram lrcAge_{"lrc->stc"};
+    Latency::LatencyHistogram brakeAge_{"scan->brake"};
+    Latency::LatencyHistogram scanFuseAge_{"scan->fuse"};
+    Latency::LatencyHistogram cameraFuseAge_{"camera->fuse"};
+
+    //Emergency brake fast path, latched by objectCallback until the gap opens
+    std::atomic<bool> emergencyBrake_{false};
+    std::atomic<uint32_t> brakeCnt_{0};
+    std::atomic<uint32_t> brakeLate_{0};
+    double lidarPeriod_;
     
     //ZMQ
     ZMQ_CLASS ZMQ_SOCKET_;
     ZmqData* zmq_data_;
     ImgData* img_data_;
-    ImgData* backup_data_;
 
     //Thread
     std::thread controlThread_;
@@ -163,49 +256,78 @@ class ScaleTruckController {
     std::thread objectDetectThread_;
     std::thread tcpThread_;
     std::thread tcpImgReqThread_;
-    std::thread tcpImgRepThread_;
+    std::thread encoderThread_;
+    std::thread decoderThread_;
 
     std::mutex image_mutex_;
     std::mutex rear_image_mutex_;
     std::mutex object_mutex_;
-    std::mutex lane_mutex_;
-    std::mutex vel_mutex_;
-    std::mutex dist_mutex_;
-    std::mutex rep_mutex_;
-    std::mutex mode_mutex_;
-    std::mutex bbox_mutex_;
 
-    std::condition_variable cv_;
+    //Lateral loop runs per camera frame, longitudinal loop per lidar scan
+    std::condition_variable scan_cv_;
+    uint32_t scanSeq_ = 0;
+    int statusPeriod_;
+    RTUtil::DeadlineMonitor longitudinalMonitor_{"longitudinal"};
+
+    //RT mode, core < 0 = not pinned, priority used only when rtEnable_
+    bool rtEnable_;
+    bool rtLockMemory_;
+    double cycleBudget_;
+    int laneCore_, objectCore_, controlCore_, tcpCore_, imageCore_;
+    int lanePrio_, objectPrio_, controlPrio_, tcpPrio_, imagePrio_;
+    RTUtil::DeadlineMonitor cycleMonitor_{"lateral"};
 
-    obstacle_detector::Obstacles Obstacle_;
+    //QoS, the lateral loop degrades LaneDetect::QosLevel steps against cycleBudget_
+    QoS::Scheduler qos_{"lateral"};
+    std::atomic<int> qosLevel_{0};  // also read by the rear image encoder
+    int qosMaxLevel_;
+    double qosDegradeRatio_, qosRecoverRatio_;
+    int qosDegradeCycles_, qosRecoverCycles_;
+
+    obstacle_detector::Obstacles::ConstPtr Obstacle_;  // latest scan, shared with the callback
     boost::shared_mutex mutexObjectCallback_;
 
     bool imageStatus_ = false;
+    uint32_t imageSeq_ = 0;
+    int frameTimeout_;
+    int frozenCnt_ = 10;
+    std::condition_variable image_cv_;
     std_msgs::Header imageHeader_;
-    cv::Mat camImageCopy_, camImageTmp_;
-    cv::Mat rearImageCopy_, rearImageTmp_, rearImageJPEG_, rearImageBackup_;
-    bool droi_ready_ = false;
+    TripleBuffer<CameraFrame> cameraFrames_;  // imageCallback -> lane thread
+    cv_bridge::CvImageConstPtr camImagePrev_, rearImage_;
+    cv::Mat camImageTmp_, rearImageJPEG_;
+    std::atomic<int> droiDistance_{0};  // latest dynamic ROI distance for the lane detector
 
     bool isNodeRunning_ = true;
     bool controlDone_ = false;
 
-    float CurVel_ = 0.0f;
     float RefVel_ = 0.0f;
      
     void* lanedetectInThread();
     void* objectdetectInThread();
 
-    bool req_lv_ = false;
-    bool run_yolo_ = false;
+    std::atomic<bool> req_lv_{false};  // rear image from the LV wanted
+    std::atomic<bool> run_yolo_{false};
     bool tcp_img_req_ = false;
-    bool tcp_img_rep_ = false;
     int req_check_ = 0;
     int rep_check_ = 0;
     double time_ = 0.0;
     double DelayTime_ = 0.0;
-    std::vector<uchar> compImageSend_;
-    std::vector<uchar> compImageRecv_;
-    std::vector<uchar> compImageBackup_;
+    std::shared_ptr<const std::vector<uchar>> compImageSend_;  // latest rear JPEG, shared with the request thread
+
+    //rear image encoder, guarded by rear_image_mutex_
+    std::condition_variable rear_cv_;
+    std::condition_variable jpeg_cv_;
+    uint32_t rearSeq_ = 0;
+    uint32_t jpegSeq_ = 0;
+    std::atomic<uint32_t> jpegSkipped_{0};  // superseded before they could be sent
+
+    //rear image decoder, the reactor only copies the JPEG in, guarded by rear_image_mutex_
+    std::condition_variable decode_cv_;
+    std::shared_ptr<const std::vector<uchar>> compImageRecv_;
+    ImgData imgRecv_;  // header of compImageRecv_, comp_image not used
+    uint32_t recvSeq_ = 0;
+    std::atomic<uint32_t> recvSkipped_{0};  // superseded before they could be decoded
 };
 
 } /* namespace scale_truck_control */
@@ -0,0 +1,84 @@
+/*
+ * seqlock.hpp
+ *
+ * Sequence lock for small, trivially copyable state snapshots.
+ * Readers never block: load() retries while a write is in flight and
+ * always returns a consistent copy. Writers are serialized by an
+ * internal mutex, so several threads may publish into the same lock.
+ * The payload is kept in relaxed atomic words, which keeps the racing
+ * copy well defined.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+namespace scale_truck_control {
+
+template <typename T>
+class Seqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "Seqlock payload must be trivially copyable");
+
+  public:
+    Seqlock() : seq_(0) { write(T()); }
+    explicit Seqlock(const T& value) : seq_(0) { write(value); }
+
+    T load() const {
+      uint32_t buf[WORDS];
+      uint32_t before, after;
+      do {
+        before = seq_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < WORDS; i++) {
+          buf[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = seq_.load(std::memory_order_relaxed);
+      } while ((before & 1) || (before != after));
+
+      T value;
+      memcpy(&value, buf, sizeof(T));
+      return value;
+    }
+
+    void store(const T& value) {
+      std::scoped_lock lock(write_mutex_);
+      write(value);
+    }
+
+    /* Read-modify-write, fn receives the current value by reference */
+    template <typename F>
+    void update(F fn) {
+      std::scoped_lock lock(write_mutex_);
+      T value = load();
+      fn(value);
+      write(value);
+    }
+
+    uint32_t sequence() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+  private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    void write(const T& value) {
+      uint32_t buf[WORDS] = {0,};
+      memcpy(buf, &value, sizeof(T));
+
+      uint32_t seq = seq_.load(std::memory_order_relaxed);
+      seq_.store(seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      for (size_t i = 0; i < WORDS; i++) {
+        words_[i].store(buf[i], std::memory_order_relaxed);
+      }
+      seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    std::atomic<uint32_t> seq_;
+    std::atomic<uint32_t> words_[WORDS];
+    std::mutex write_mutex_;
+};
+
+} /* namespace scale_truck_control */
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <string>
+#include <vector>
+
+#include "seqlock/seqlock.hpp"
+
+namespace StatsShm {
+
+#define STATS_LINES 48
+#define STATS_LINE_LEN 100
+#define STATS_PREFIX "scale_truck_"  // shm objects show up as /dev/shm/scale_truck_*
+
+/* One status page, rendered line by line by stc_top */
+typedef struct StatsData{
+	char title[64];
+	uint32_t lines;
+	uint64_t updated_us;
+	char line[STATS_LINES][STATS_LINE_LEN];
+}StatsData;
+
+typedef scale_truck_control::Seqlock<StatsData> StatsBlock;
+
+/* Owner side, one per process. Never blocks on the reader */
+class StatsWriter{
+public:
+	explicit StatsWriter(const std::string& name);
+	~StatsWriter();
+
+	bool valid() const { return block_ != nullptr; }
+	void begin(const char* title);
+	void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+	void commit();
+
+private:
+	std::string name_;
+	StatsBlock* block_ = nullptr;
+	StatsData data_;
+};
+
+/* Viewer side, maps the block read-only */
+class StatsReader{
+public:
+	explicit StatsReader(const std::string& name);
+	~StatsReader();
+
+	bool valid() const { return block_ != nullptr; }
+	bool read(StatsData* data) const;
+	const std::string& name() const { return name_; }
+
+	static std::vector<std::string> list();  // all blocks in /dev/shm
+
+private:
+	std::string name_;
+	const StatsBlock* block_ = nullptr;
+};
+
+}
@@ -0,0 +1,50 @@
+/*
+ * triple_buffer.hpp
+ *
+ * Lock-free single producer / single consumer triple buffer.
+ * The producer fills back() and publish()es it, the consumer calls
+ * update() and reads front(). Neither side ever waits or copies a slot,
+ * only slot indices are exchanged.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace scale_truck_control {
+
+template <typename T>
+class TripleBuffer {
+  public:
+    TripleBuffer() : front_(0), middle_(1), back_(2) {}
+
+    /* Producer side */
+    T& back() { return slots_[back_]; }
+
+    void publish() {
+      uint8_t prev = middle_.exchange(back_ | DIRTY, std::memory_order_acq_rel);
+      back_ = prev & INDEX;
+    }
+
+    /* Consumer side, returns true if a newer slot was taken */
+    bool update() {
+      if (!(middle_.load(std::memory_order_acquire) & DIRTY)) return false;
+      uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+      front_ = prev & INDEX;
+      return true;
+    }
+
+    const T& front() const { return slots_[front_]; }
+
+  private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t DIRTY = 0x4;
+
+    T slots_[3];
+    uint8_t front_;                 // owned by the consumer
+    std::atomic<uint8_t> middle_;   // shared, index | DIRTY
+    uint8_t back_;                  // owned by the producer
+};
+
+} /* namespace scale_truck_control */
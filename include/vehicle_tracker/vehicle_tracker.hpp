@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cmath>
+#include <ros/ros.h>
+#include <obstacle_detector/Obstacles.h>
+
+namespace VehicleTracker {
+
+/* Preceding truck, gap measured like objectdetectInThread: -center.x - true_radius */
+typedef struct Track{
+	float range = 10.1f;      // m, filtered at stamp
+	float range_rate = 0.0f;  // m/s, > 0 = gap opening
+	float lateral = 0.0f;     // m, circle center.y
+	float angle = 0.0f;       // degree
+	ros::Time stamp;          // scan of the last update
+	int hits = 0;
+	int misses = 0;
+	bool valid = false;       // confirmed and not coasted out
+}Track;
+
+/* Gated alpha-beta (constant velocity) tracker on the obstacle_detector circles */
+class Tracker{
+public:
+	explicit Tracker(ros::NodeHandle nh);
+
+	const Track& update(const obstacle_detector::Obstacles::ConstPtr& scan);
+	float predictRange(const ros::Time& now) const;
+	const Track& track() const { return track_; }
+	void reset();
+
+private:
+	bool associate(const obstacle_detector::Obstacles& scan, float pred_range, int* best) const;
+	bool acquire(const obstacle_detector::Obstacles& scan, int* best) const;
+
+	ros::NodeHandle nodeHandle_;
+	float gate_range_;       // m around the predicted range
+	float gate_lateral_;     // m around the last lateral offset
+	float lane_half_width_;  // m, new tracks only start inside our lane
+	float alpha_, beta_;
+	float max_rate_;         // m/s
+	double max_predict_;     // s, extrapolation horizon
+	int confirm_hits_;
+	int max_coast_;          // scans without a match before the track is dropped
+
+	Track track_;
+};
+
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+
+/* Shared by the STC and LRC nodes, the CRC (etc/Controller/crc) and the Qt
+ * controller (etc/Controller/Controller), each builds src/zmq_wire.cpp */
+
+typedef struct LaneCoef{
+	float a = 0.0f;
+	float b = 0.0f;
+	float c = 0.0f;
+}LaneCoef;
+
+/* Rear image header. The JPEG is not copied in: on the sender it stays in the
+ * encoder's buffer, on the receiver comp_image points into the received frame
+ * and is valid only during the ImageFn call */
+typedef struct ImgData{
+	uint8_t src_index = 255;
+	uint8_t tar_index = 255;
+
+	struct timeval startTime;
+	uint32_t seq = 0;
+
+	const u_char* comp_image = nullptr;
+	size_t size = 0;
+
+	bool clock_synced = false;  // receiver: startTime converted to the local clock
+}ImgData;
+
+typedef struct ZmqData{
+	//Control center = 15, 20, CRC = 30, LRC = 10, 11, 12, LV = 0, FV1 = 1, FV2 = 2
+	uint8_t src_index = 255;
+	uint8_t tar_index = 255;
+	
+	//sensor failure
+	bool fi_encoder = false;
+	bool fi_camera = false;
+	bool fi_lidar = false;
+	bool alpha = false;
+	bool beta = false;
+	bool gamma = false;
+
+	//flag to send rear camera sensor image
+	bool send_rear_camera_image = false;
+
+	float ref_vel = 0.0f;
+	float cur_vel = 0.0f;
+	float cur_dist = 0.0f;
+	float cur_angle = 0.0f;
+	float tar_vel = 0.0f;
+	float tar_dist = 0.0f;
+	float est_vel = 0.0f;  //estimated velocity
+	float preceding_truck_vel = 0.0f;
+
+	//TM = 0, RCM = 1, GDM = 2
+	uint8_t lrc_mode = 0;
+	uint8_t crc_mode = 0;
+
+	//lateral QoS step of the STC, LaneDetect::QosLevel, 0 = full vision
+	uint8_t qos_level = 0;
+
+	LaneCoef coef[3];
+
+	//latency stamps, camera frame the data is based on and send time
+	struct timeval image_stamp = {0, 0};
+	struct timeval send_stamp = {0, 0};
+
+	//receiver only, not on the wire: stamps converted to the local clock, ages across hosts are valid
+	bool clock_synced = false;
+}ZmqData;
+
+namespace ZmqWire {
+
+/* Explicit little-endian encoding of ZmqData, independent of the struct layout.
+ *
+ *  header   0 magic 0xA5
+ *           1 version
+ *           2 type (MSG_*)
+ *           3 src_index
+ *           4 tar_index
+ *           5 lrc_mode << 6 | crc_mode << 4 | qos_level
+ *           6 flags (u16, FLAG_*)
+ *           8 seq (u32)
+ *          12 ack (u32), newest seq received from the peer, valid with FLAG_ACK
+ *          16 ack_delay (u32 us), time the sender held ack before this packet
+ *  body    20 ref_vel, cur_vel, cur_dist, cur_angle, tar_vel, tar_dist,
+ *             est_vel, preceding_truck_vel, coef[3].a/b/c
+ *             f32 for MSG_TELEMETRY, f16 for MSG_BEACON
+ *           + image_stamp, send_stamp (i64 us)
+ *  trailer    CRC-16/CCITT over everything before it
+ *
+ * MSG_IMAGE is a two frame message, this header then the JPEG as is:
+ *
+ *  header   0 magic, 1 version, 2 type, 3 src_index, 4 tar_index
+ *           5 reserved, 6 flags (u16, FLAG_CLOCK)
+ *           8 seq (u32)
+ *          12 size (u32), JPEG bytes in the second frame
+ *          16 stamp (i64 us)
+ *          24 clock (i64 us), receiver - sender clock as the sender sees it, valid with FLAG_CLOCK
+ *  trailer 32 CRC-16/CCITT over the header, the JPEG is left to the decoder
+ *
+ * MSG_IMAGE_ACK answers it: common header to 8, seq (u32) of the image,
+ * receive and send stamps (i64 us) of the receiver, CRC-16. The sender gets
+ * the four stamps of an NTP exchange from it.
+ *
+ * Any change to the layout bumps VERSION, old peers then drop the packets.
+ */
+
+#define WIRE_MAGIC 0xA5
+#define WIRE_VERSION 4
+
+enum MsgType : uint8_t {
+	MSG_TELEMETRY = 1,  // TCP links, full precision
+	MSG_BEACON = 2,     // UDP multicast, float16 quantized
+	MSG_IMAGE = 3,      // rear image header, JPEG in the next frame
+	MSG_IMAGE_ACK = 4   // rear image receipt, with the receiver's stamps
+};
+
+enum Flag : uint16_t {
+	FLAG_FI_ENCODER = 1 << 0,
+	FLAG_FI_CAMERA = 1 << 1,
+	FLAG_FI_LIDAR = 1 << 2,
+	FLAG_ALPHA = 1 << 3,
+	FLAG_BETA = 1 << 4,
+	FLAG_GAMMA = 1 << 5,
+	FLAG_REAR_IMAGE = 1 << 6,
+	FLAG_ACK = 1 << 7,
+	FLAG_CLOCK = 1 << 8
+};
+
+/* Acknowledgement piggybacked on a packet, gives the peer its RTT */
+struct Ack {
+	uint32_t seq = 0;
+	uint32_t delay_us = 0;
+	bool valid = false;
+};
+
+/* Sender's estimate of the receiver's clock, receiver - sender */
+struct ClockHint {
+	int64_t offset_us = 0;
+	bool valid = false;
+};
+
+struct ImageAck {
+	uint32_t seq = 0;
+	int64_t rx_us = 0;  // receiver clock, image header received
+	int64_t tx_us = 0;  // receiver clock, this ack sent
+};
+
+constexpr size_t HEADER_SIZE = 20;
+constexpr size_t FLOATS = 17;
+constexpr size_t STAMPS_SIZE = 2 * 8;
+constexpr size_t CRC_SIZE = 2;
+constexpr size_t TELEMETRY_SIZE = HEADER_SIZE + FLOATS * 4 + STAMPS_SIZE + CRC_SIZE;
+constexpr size_t BEACON_SIZE = HEADER_SIZE + FLOATS * 2 + STAMPS_SIZE + CRC_SIZE;
+constexpr size_t MAX_SIZE = TELEMETRY_SIZE;
+constexpr size_t IMAGE_HEADER_SIZE = 16 + 2 * 8 + CRC_SIZE;
+constexpr size_t IMAGE_ACK_SIZE = 12 + 2 * 8 + CRC_SIZE;
+
+static_assert(TELEMETRY_SIZE == 106, "telemetry layout changed, bump WIRE_VERSION");
+static_assert(BEACON_SIZE == 72, "beacon layout changed, bump WIRE_VERSION");
+static_assert(IMAGE_HEADER_SIZE == 34, "image header layout changed, bump WIRE_VERSION");
+static_assert(IMAGE_ACK_SIZE == 30, "image ack layout changed, bump WIRE_VERSION");
+
+/* Writes one packet into buf (MAX_SIZE bytes), returns its size */
+size_t encode(const ZmqData& data, MsgType type, uint32_t seq, uint8_t* buf, const Ack* ack = nullptr);
+
+/* Validates magic, version, size and checksum. data, seq and ack are left
+ * untouched unless the packet is good */
+bool decode(const void* buf, size_t size, ZmqData* data, uint32_t* seq = nullptr, Ack* ack = nullptr);
+
+/* Image header for img, whose JPEG goes in the next frame. buf is IMAGE_HEADER_SIZE bytes */
+size_t encodeImage(const ImgData& img, uint32_t seq, uint8_t* buf, const ClockHint* clock = nullptr);
+
+/* Checks the header against the JPEG frame size, fills img except comp_image */
+bool decodeImage(const void* buf, size_t size, size_t payload_size, ImgData* img, ClockHint* clock = nullptr);
+
+/* buf is IMAGE_ACK_SIZE bytes */
+size_t encodeImageAck(uint8_t src_index, uint8_t tar_index, const ImageAck& ack, uint8_t* buf);
+bool decodeImageAck(const void* buf, size_t size, ImageAck* ack);
+
+/* Same content, ignoring seq, ack, send_stamp and the checksum. Both packets size bytes */
+bool samePayload(const uint8_t* a, const uint8_t* b, size_t size);
+
+uint16_t crc16(const uint8_t* buf, size_t size);
+uint16_t toHalf(float value);
+float fromHalf(uint16_t half);
+
+}
@@ -0,0 +1,322 @@
+/*
+ * comm_harness.cpp
+ *
+ * Whole platoon communication stack on one machine, no cameras or lidars.
+ *   ctl0..2    control center, one DEALER per STC
+ *   stc0..2    ScaleTruckController ROUTER
+ *   lrc10..12  LocalRC DEALER to the CRC, LV radio -> FV dishes
+ *   crc        CentralRC, one ROUTER for all LRCs
+ * STC -> LRC (ROS topics on the trucks) is bridged in memory. Every send
+ * carries scripted velocities and gaps, the control center steps the LV
+ * target every step_period_ms and the harness times how long each step
+ * takes to reach the LV STC and the FV LRCs.
+ * Usage: roslaunch scale_truck_control comm_harness.launch transport:=ipc
+ * Exit status 1 when a link stays silent or its p99 age exceeds max_p99_ms.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <array>
+#include <map>
+#include <memory>
+
+#include "zmq_class/zmq_class.h"
+#include "latency/latency.hpp"
+
+typedef struct HarnessLink{
+  explicit HarnessLink(const std::string& name) : age(name) {}
+  Latency::LatencyHistogram age;  // send_stamp -> handler
+  std::atomic<uint32_t> count{0};
+}HarnessLink;
+
+typedef struct HarnessNode{
+  std::string name;
+  std::unique_ptr<ZMQ_CLASS> zmq;
+  ZmqData send;
+  ZmqData beacon;  // LV radio, target only so it stays change driven
+  std::thread thread;
+}HarnessNode;
+
+/* LV target step, encoded in tar_vel so every hop can tell which step it sees */
+typedef struct HarnessStep{
+  std::atomic<uint32_t> id{0};
+  std::atomic<int64_t> start{0};  // steady clock, ns
+}HarnessStep;
+
+/* Time from a step to the first packet carrying it, per checkpoint */
+typedef struct HarnessProbe{
+  explicit HarnessProbe(const std::string& name) : name(name), delay(name) {}
+  std::string name;
+  Latency::LatencyHistogram delay;
+  std::atomic<uint32_t> seen{0};  // last step id recorded
+  std::atomic<uint32_t> hits{0};
+}HarnessProbe;
+
+static int64_t nowNs(){
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+static float stepTarget(uint32_t id){
+  return 0.5f + 0.01f * (id % 50);  // exact enough for float16 beacons
+}
+
+class CommHarness{
+  public:
+    explicit CommHarness(ros::NodeHandle nh);
+    int run();
+
+  private:
+    void endpoints(const std::string& link, int port, std::string* server, std::string* client);
+    HarnessNode* addNode(const std::string& name, const std::map<std::string, std::string>& params);
+    HarnessLink* link(const std::string& name);
+    void probe(HarnessProbe* probe, float tar_vel);
+    void scripted(ZmqData* data, int truck);
+    int report(double seconds);
+
+    ros::NodeHandle nodeHandle_;
+    std::string transport_, beaconEndpoint_;
+    int duration_, stepPeriod_, sendPeriod_, basePort_;
+    double maxP99_;
+
+    zmq::context_t context_{1};  // shared, inproc:// only connects within one context
+    std::vector<std::unique_ptr<HarnessNode>> nodes_;
+    std::map<std::string, std::unique_ptr<HarnessLink>> links_;
+
+    HarnessStep step_;
+    HarnessProbe stcProbe_{"step->stc0"};
+    HarnessProbe fv1Probe_{"step->lrc11"};
+    HarnessProbe fv2Probe_{"step->lrc12"};
+    std::atomic<float> truckTarget_[3];  // STC -> LRC bridge
+};
+
+CommHarness::CommHarness(ros::NodeHandle nh)
+  : nodeHandle_(nh){
+  nodeHandle_.param("transport", transport_, std::string("ipc"));  // ipc, inproc or tcp
+  nodeHandle_.param("beacon_endpoint", beaconEndpoint_, std::string(""));  // e.g. udp://239.255.255.250:9090
+  nodeHandle_.param("duration_s", duration_, 10);
+  nodeHandle_.param("step_period_ms", stepPeriod_, 200);
+  nodeHandle_.param("send_period_ms", sendPeriod_, SEND_PERIOD);
+  nodeHandle_.param("base_port", basePort_, 17700);
+  nodeHandle_.param("max_p99_ms", maxP99_, 20.0);
+  for(auto& target : truckTarget_) target = 0.0f;
+}
+
+void CommHarness::endpoints(const std::string& link, int port, std::string* server, std::string* client){
+  if(transport_ == "tcp"){
+    *server = "tcp://*:" + std::to_string(port);
+    *client = "tcp://127.0.0.1:" + std::to_string(port);
+  }
+  else if(transport_ == "inproc"){
+    *server = *client = "inproc://" + link;
+  }
+  else{
+    *server = *client = "ipc:///tmp/stc_harness_" + link;
+  }
+}
+
+HarnessNode* CommHarness::addNode(const std::string& name, const std::map<std::string, std::string>& params){
+  for(auto& param : params){
+    if(param.second == "true" || param.second == "false") nodeHandle_.setParam(name + "/" + param.first, param.second == "true");
+    else nodeHandle_.setParam(name + "/" + param.first, param.second);
+  }
+  nodeHandle_.setParam(name + "/socket/send_period_ms", sendPeriod_);
+
+  nodes_.emplace_back(new HarnessNode);
+  HarnessNode* node = nodes_.back().get();
+  node->name = name;
+  node->zmq.reset(new ZMQ_CLASS(ros::NodeHandle(nodeHandle_, name), &context_));
+  return node;
+}
+
+HarnessLink* CommHarness::link(const std::string& name){
+  auto& entry = links_[name];
+  if(!entry) entry.reset(new HarnessLink(name));
+  return entry.get();
+}
+
+void CommHarness::probe(HarnessProbe* probe, float tar_vel){
+  uint32_t id = step_.id;
+  if(id == 0 || probe->seen == id || fabs(tar_vel - stepTarget(id)) > 0.002f) return;
+  probe->seen = id;
+  probe->hits++;
+  probe->delay.record((nowNs() - step_.start) / 1e6);
+}
+
+/* Sensor values a truck would report, slow sine so every packet differs */
+void CommHarness::scripted(ZmqData* data, int truck){
+  double t = nowNs() / 1e9;
+  data->cur_vel = truckTarget_[truck] + 0.02f * sin(t + truck);
+  data->cur_dist = 0.8f + 0.1f * sin(0.5 * t + truck);
+  data->ref_vel = truckTarget_[truck];
+}
+
+int CommHarness::run(){
+  std::string server, client;
+  int port = basePort_;
+
+  /* Servers first, inproc:// needs the bind before the connect.
+   * The CRC answers every LRC with the same payload, the real one addresses a reply per truck */
+  endpoints("crc", port + 30, &server, &client);
+  HarnessNode* crc = addNode("crc", {{"socket/rep_flag", "true"}, {"tcp_ip/rep_endpoint", server}});
+  crc->send.src_index = 30;
+  crc->send.tar_index = 10;
+  std::array<HarnessLink*, 3> crc_rx;
+  for(int i = 0; i < 3; i++) crc_rx[i] = link("lrc" + std::to_string(10 + i) + "->crc");
+  crc->zmq->onReply(&crc->send,
+    [](ZmqData* data) { data->crc_mode = 0; },
+    [crc, crc_rx](ZmqData* data) {
+      if(data->src_index < 10 || data->src_index > 12) return;
+      HarnessLink* rx = crc_rx[data->src_index - 10];
+      rx->age.record(data->send_stamp);
+      rx->count++;
+      crc->send.est_vel = data->cur_vel;
+    });
+
+  for(int i = 0; i < 3; i++){
+    endpoints("stc" + std::to_string(i), port + i, &server, &client);
+    HarnessNode* stc = addNode("stc" + std::to_string(i), {{"socket/rep_flag", "true"}, {"tcp_ip/rep_endpoint", server}});
+    stc->send.src_index = i;
+    stc->send.tar_index = 20;
+    HarnessLink* rx = link("ctl" + std::to_string(i) + "->stc" + std::to_string(i));
+    stc->zmq->onReply(&stc->send,
+      [this, i](ZmqData* data) { scripted(data, i); },
+      [this, i, rx](ZmqData* data) {
+        rx->age.record(data->send_stamp);
+        rx->count++;
+        if(i == 0){  //LV applies the control center target
+          truckTarget_[0] = data->tar_vel;
+          probe(&stcProbe_, data->tar_vel);
+        }
+      });
+  }
+
+  std::string beacon_server, beacon_client;
+  endpoints("beacon", port + 90, &beacon_server, &beacon_client);
+  if(!beaconEndpoint_.empty()) beacon_server = beacon_client = beaconEndpoint_;
+
+  endpoints("crc", port + 30, &server, &client);
+  for(int i = 0; i < 3; i++){
+    int lrc = 10 + i;
+    std::map<std::string, std::string> params = {{"socket/req_flag", "true"}, {"tcp_ip/req_endpoint", client},
+      {"udp_ip/send_group", "FV"}, {"udp_ip/recv_group", "FV"}};
+    if(i == 0){
+      params["socket/rad_flag"] = "true";
+      params["udp_ip/endpoint"] = beacon_server;
+    }
+    else{
+      params["socket/dsh_flag"] = "true";
+      params["udp_ip/endpoint"] = beacon_client;
+    }
+    HarnessNode* node = addNode("lrc" + std::to_string(lrc), params);
+    node->send.src_index = lrc;
+    node->send.tar_index = 30;
+    HarnessLink* rx = link("crc->lrc" + std::to_string(lrc));
+    node->zmq->onRequest(&node->send,
+      [this, i](ZmqData* data) { scripted(data, i); data->tar_vel = truckTarget_[i]; },
+      [rx](ZmqData* data) {
+        rx->age.record(data->send_stamp);
+        rx->count++;
+      });
+
+    if(i == 0){
+      node->beacon.src_index = lrc;
+      node->zmq->onRadio(&node->beacon, [this](ZmqData* data) { data->tar_vel = truckTarget_[0]; });
+    }
+    else{
+      HarnessLink* beacon = link("lrc10->lrc" + std::to_string(lrc));
+      HarnessProbe* fv_probe = (i == 1) ? &fv1Probe_ : &fv2Probe_;
+      node->zmq->onDish([this, i, beacon, fv_probe](ZmqData* data) {
+        beacon->age.record(data->send_stamp);
+        beacon->count++;
+        truckTarget_[i] = data->tar_vel;
+        probe(fv_probe, data->tar_vel);
+      });
+    }
+  }
+
+  for(int i = 0; i < 3; i++){
+    endpoints("stc" + std::to_string(i), port + i, &server, &client);
+    HarnessNode* ctl = addNode("ctl" + std::to_string(i), {{"socket/req_flag", "true"}, {"tcp_ip/req_endpoint", client}});
+    ctl->send.src_index = 20;
+    ctl->send.tar_index = i;
+    HarnessLink* rx = link("stc" + std::to_string(i) + "->ctl" + std::to_string(i));
+    ctl->zmq->onRequest(&ctl->send,
+      [this, i](ZmqData* data) {
+        data->tar_vel = (i == 0 && step_.id) ? stepTarget(step_.id) : 0.0f;
+        data->tar_dist = 0.8f;
+      },
+      [rx](ZmqData* data) {
+        rx->age.record(data->send_stamp);
+        rx->count++;
+      });
+  }
+
+  ROS_INFO("[Harness] %zu nodes over %s, %d s", nodes_.size(), transport_.c_str(), duration_);
+  for(auto& node : nodes_){
+    ZMQ_CLASS* zmq = node->zmq.get();
+    node->thread = std::thread([zmq]() { zmq->spin(); });
+  }
+
+  /* Warm-up second, then the stats start clean */
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  for(auto& entry : links_){
+    entry.second->age.reset();
+    entry.second->count = 0;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto end = start + std::chrono::seconds(duration_);
+  while(ros::ok() && std::chrono::steady_clock::now() < end){
+    step_.start = nowNs();
+    step_.id++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(stepPeriod_));
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for(auto& node : nodes_) node->zmq->controlDone_ = true;
+  for(auto& node : nodes_) node->thread.join();
+  int status = report(seconds);
+  nodes_.clear();
+  return status;
+}
+
+int CommHarness::report(double seconds){
+  int status = 0;
+  printf("\n%-16s %10s %8s %8s %8s\n", "link", "msg/s", "mean", "p99", "max");
+  for(auto& entry : links_){
+    HarnessLink* link = entry.second.get();
+    double p99 = link->age.percentile(0.99);
+    bool fail = link->count == 0 || p99 > maxP99_;
+    printf("%-16s %10.1f %8.3f %8.3f %8.3f%s\n", entry.first.c_str(), link->count / seconds,
+      link->age.mean(), p99, link->age.max(), fail ? "  FAIL" : "");
+    if(fail) status = 1;
+  }
+
+  printf("\n%-16s %10s %8s %8s %8s\n", "step", "reached", "mean", "p99", "max");
+  for(HarnessProbe* probe : {&stcProbe_, &fv1Probe_, &fv2Probe_}){
+    bool fail = probe->hits == 0;
+    printf("%-16s %4u / %-5u %8.3f %8.3f %8.3f%s\n", probe->name.c_str(), probe->hits.load(), step_.id.load(),
+      probe->delay.mean(), probe->delay.percentile(0.99), probe->delay.max(), fail ? "  FAIL" : "");
+    if(fail) status = 1;
+  }
+
+  for(auto& node : nodes_){
+    const BeaconStats& beacon = node->zmq->beacon_stats_;
+    if(beacon.sent) printf("\n%s beacons: %u sent, %u suppressed\n", node->name.c_str(), beacon.sent.load(), beacon.suppressed.load());
+    if(beacon.received) printf("%s beacons: %u rx, %.2f%% lost, %u late\n", node->name.c_str(), beacon.received.load(), beacon.lossRate() * 100.0f, beacon.late.load());
+    if(node->zmq->wire_errors_) printf("%s wire errors: %u\n", node->name.c_str(), node->zmq->wire_errors_.load());
+  }
+
+  printf("\n");
+  for(auto& node : nodes_){
+    for(const std::string& line : node->zmq->healthReport()) printf("%-6s %s\n", node->name.c_str(), line.c_str());
+  }
+  return status;
+}
+
+int main(int argc, char** argv) {
+  ros::init(argc, argv, "comm_harness");
+  ros::NodeHandle nodeHandle("~");
+  CommHarness harness(nodeHandle);
+  return harness.run();
+}
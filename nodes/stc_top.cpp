@@ -0,0 +1,60 @@
+/*
+ * stc_top.cpp
+ *
+ * Terminal viewer for the stats pages published by the STC, LRC and CRC.
+ * Usage: stc_top [name ...]  e.g. stc_top stc0 lrc10, no args = all pages
+ */
+
+#include <stdio.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <memory>
+
+#include "stats_shm/stats_shm.hpp"
+
+static volatile sig_atomic_t running = 1;
+
+static void onSignal(int){
+  running = 0;
+}
+
+int main(int argc, char** argv){
+  int period_ms = 200;
+  std::vector<std::string> names;
+  for (int i = 1; i < argc; i++) {
+    names.push_back(argv[i]);
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  StatsShm::StatsData data;
+  while (running) {
+    const std::vector<std::string> pages = names.empty() ? StatsShm::StatsReader::list() : names;
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    const uint64_t now_us = (uint64_t)now.tv_sec * 1000000ULL + now.tv_usec;
+
+    printf("\033[2J\033[1;1H");
+    if (pages.empty()) {
+      printf("No stats pages in /dev/shm (%s*)\n", STATS_PREFIX);
+    }
+    for (const std::string& name : pages) {
+      StatsShm::StatsReader reader(name);
+      if (!reader.read(&data)) {
+        printf("[%s] not running\n\n", name.c_str());
+        continue;
+      }
+      const double age_ms = (now_us > data.updated_us) ? (now_us - data.updated_us) / 1000.0 : 0.0;
+      printf("[%s] %s  (%.0f ms ago%s)\n", name.c_str(), data.title, age_ms, age_ms > 1000.0 ? ", STALE" : "");
+      for (uint32_t i = 0; i < data.lines; i++) {
+        printf("  %s\n", data.line[i]);
+      }
+      printf("\n");
+    }
+    fflush(stdout);
+    usleep(period_ms * 1000);
+  }
+  return 0;
+}
@@ -3,7 +3,7 @@
 namespace scale_truck_control{
 
 ScaleTruckController::ScaleTruckController(ros::NodeHandle nh)
-    : nodeHandle_(nh), laneDetector_(nodeHandle_), ZMQ_SOCKET_(nh), imageTransport_(nh){
+    : nodeHandle_(nh), laneDetector_(nodeHandle_), objectDetector_(nodeHandle_), tracker_(nodeHandle_), distFusion_(nodeHandle_), bboxTracker_(nodeHandle_), ZMQ_SOCKET_(nh), imageTransport_(nh){
   if (!readParameters()) {
     ros::requestShutdown();
   }
@@ -14,33 +14,23 @@ ScaleTruckController::ScaleTruckController(ros::NodeHandle nh)
 ScaleTruckController::~ScaleTruckController() {
   isNodeRunning_ = false;
 
-  scale_truck_control::xav2lrc msg;
-  msg.tar_vel = ResultVel_;
-  {
-    std::scoped_lock lock(dist_mutex_);
-    msg.steer_angle = AngleDegree_;
-    msg.cur_dist = distance_;
-  }
-  {
-    std::scoped_lock lock(rep_mutex_);
-    msg.tar_dist = TargetDist_;
-    msg.fi_encoder = fi_encoder_;
-    msg.fi_camera = fi_camera_;
-    msg.fi_lidar = fi_lidar_;
-    msg.beta = beta_;
-    msg.gamma = gamma_;
-  }
-
-  XavPublisher_.publish(msg);
+  XavPublisher_.publish(xavMessage());
   controlThread_.join();
+  image_cv_.notify_all();
+  scan_cv_.notify_all();
+  rear_cv_.notify_all();
+  jpeg_cv_.notify_all();
+  decode_cv_.notify_all();
+  laneDetectThread_.join();
+  objectDetectThread_.join();
   tcpThread_.join();
+  if (encoderThread_.joinable()) encoderThread_.join();
+  if (decoderThread_.joinable()) decoderThread_.join();
 
   delete zmq_data_;
   delete img_data_;
 
-  if (rear_camera_) delete backup_data_;
-  if (send_rear_camera_image_ && (index_ == 0 || index_ == 1)) tcpImgReqThread_.join();
-  if (req_lv_ && (index_ == 1 || index_ == 2)) tcpImgRepThread_.join();
+  if (tcp_img_req_) tcpImgReqThread_.join();
 
   ROS_INFO("[ScaleTruckController] Stop.");
 }
@@ -52,6 +42,8 @@ bool ScaleTruckController::readParameters() {
   nodeHandle_.param("image_view/enable_opencv", viewImage_, true);
   nodeHandle_.param("image_view/wait_key_delay", waitKeyDelay_, 3);
   nodeHandle_.param("image_view/enable_console_output", enableConsoleOutput_, true);
+  nodeHandle_.param("object_detect/enable", objectDetectEnable_, true);
+  nodeHandle_.param("bbox_tracker/enable", bboxTrackerEnable_, true);
 
   /***********************************/
   /* Rear camera sensor usage Option */
@@ -81,6 +73,31 @@ bool ScaleTruckController::readParameters() {
   nodeHandle_.param("params/LdOffset", Ld_offset_, 0.0f);
   nodeHandle_.param("params/LdOffset2", Ld_offset2_, 0.0f);
 
+  /*******************/
+  /*  Thread Option  */
+  /*******************/
+  nodeHandle_.param("threads/lane_core", laneCore_, -1); // -1 = not pinned
+  nodeHandle_.param("threads/object_core", objectCore_, -1);
+  nodeHandle_.param("threads/control_core", controlCore_, -1);
+  nodeHandle_.param("threads/tcp_core", tcpCore_, -1);
+  nodeHandle_.param("threads/image_core", imageCore_, -1);
+  nodeHandle_.param("threads/lane_prio", lanePrio_, 80); // SCHED_FIFO
+  nodeHandle_.param("threads/object_prio", objectPrio_, 80);
+  nodeHandle_.param("threads/control_prio", controlPrio_, 85);
+  nodeHandle_.param("threads/tcp_prio", tcpPrio_, 70);
+  nodeHandle_.param("threads/image_prio", imagePrio_, 60);
+  nodeHandle_.param("rt/enable", rtEnable_, false);
+  nodeHandle_.param("rt/lock_memory", rtLockMemory_, true);
+  nodeHandle_.param("rt/cycle_budget_ms", cycleBudget_, 33.0);
+  nodeHandle_.param("qos/max_level", qosMaxLevel_, (int)LaneDetect::QOS_TRACK_ONLY); // 0 = never degrade
+  nodeHandle_.param("qos/degrade_ratio", qosDegradeRatio_, 0.9);
+  nodeHandle_.param("qos/recover_ratio", qosRecoverRatio_, 0.6);
+  nodeHandle_.param("qos/degrade_cycles", qosDegradeCycles_, 3);
+  nodeHandle_.param("qos/recover_cycles", qosRecoverCycles_, 30);
+  nodeHandle_.param("params/frame_timeout_ms", frameTimeout_, 100); // lidar-only cycle if no frame arrives in time
+  nodeHandle_.param("params/lidar_period_ms", lidarPeriod_, 100.0); // scan-to-brake bound, longitudinal loop timeout
+  nodeHandle_.param("params/status_period_ms", statusPeriod_, 33); // console and housekeeping
+
   return true;
 }
 
@@ -95,6 +112,8 @@ void ScaleTruckController::init() {
   int rearImageQueueSize;
   std::string objectTopicName;
   int objectQueueSize; 
+  std::string scanTopicName;
+  int scanQueueSize;
   std::string XavSubTopicName;
   int XavSubQueueSize;
   std::string bboxTopicName;
@@ -117,6 +136,8 @@ void ScaleTruckController::init() {
   nodeHandle_.param("subscribers/rear_camera_reading/queue_size", rearImageQueueSize, 1);
   nodeHandle_.param("subscribers/obstacle_reading/topic", objectTopicName, std::string("/raw_obstacles"));
   nodeHandle_.param("subscribers/obstacle_reading/queue_size", objectQueueSize, 100);
+  nodeHandle_.param("subscribers/scan_reading/topic", scanTopicName, std::string("/scan"));
+  nodeHandle_.param("subscribers/scan_reading/queue_size", scanQueueSize, 1);
   nodeHandle_.param("subscribers/lrc_to_xavier/topic", XavSubTopicName, std::string("/lrc2xav_msg"));
   nodeHandle_.param("subscribers/lrc_to_xavier/queue_size", XavSubQueueSize, 1);
   nodeHandle_.param("subscribers/yolo_detector/topic", bboxTopicName, std::string("/yolo_object_detection/bounding_box"));
@@ -139,11 +160,13 @@ void ScaleTruckController::init() {
   imageSubscriber_ = nodeHandle_.subscribe(imageTopicName, imageQueueSize, &ScaleTruckController::imageCallback, this);
   if (rear_camera_) {
     rearImageSubscriber_ = nodeHandle_.subscribe(rearImageTopicName, rearImageQueueSize, &ScaleTruckController::rearImageCallback, this);
-    backup_data_ = new ImgData;
-    backup_data_->src_index = index_;
-    backup_data_->tar_index = index_+1;
   }
-  objectSubscriber_ = nodeHandle_.subscribe(objectTopicName, objectQueueSize, &ScaleTruckController::objectCallback, this);
+  if (objectDetectEnable_) {
+    scanSubscriber_ = nodeHandle_.subscribe(scanTopicName, scanQueueSize, &ScaleTruckController::scanCallback, this);
+  }
+  else {
+    objectSubscriber_ = nodeHandle_.subscribe(objectTopicName, objectQueueSize, &ScaleTruckController::objectCallback, this);
+  }
   XavSubscriber_ = nodeHandle_.subscribe(XavSubTopicName, XavSubQueueSize, &ScaleTruckController::XavSubCallback, this);
   ScanSubError = nodeHandle_.subscribe("/scan_error", 1000, &ScaleTruckController::ScanErrorCallback, this);  
   bboxSubscriber_ = nodeHandle_.subscribe(bboxTopicName, bboxQueueSize, &ScaleTruckController::bboxCallback, this);
@@ -160,8 +183,18 @@ void ScaleTruckController::init() {
   /**********************/
   /* Safety Start Setup */
   /**********************/
-  distance_ = 10.f;
-  distAngle_ = 0;
+  CommandState cmd;
+  cmd.tar_vel = TargetVel_;
+  cmd.tar_dist = TargetDist_;
+  cmd.cc_vel = TargetVel_;
+  cmd.cc_dist = TargetDist_;
+  commandState_.store(cmd);
+
+  ControlState ctrl;
+  ctrl.distance = 10.f;
+  ctrl.dist_angle = 0;
+  ctrl.est_dist = TargetDist_;
+  controlState_.store(ctrl);
 
   /************/
   /* ZMQ Data */
@@ -174,18 +207,43 @@ void ScaleTruckController::init() {
   img_data_->src_index = index_;
   img_data_->tar_index = index_+1;
 
-  x_ = 0;
-  y_ = 0;
-  w_ = 0;
-  h_ = 0;
+  /***********/
+  /* RT Mode */
+  /***********/
+  cycleMonitor_.setBudget(cycleBudget_);
+  qos_.configure(cycleBudget_, std::min(qosMaxLevel_, (int)LaneDetect::QOS_LEVELS - 1), qosDegradeRatio_, qosRecoverRatio_, qosDegradeCycles_, qosRecoverCycles_);
+  longitudinalMonitor_.setBudget(lidarPeriod_);
+  if (rtEnable_ && rtLockMemory_) {
+    RTUtil::lockMemory(512 * 1024);
+  }
 
-  estimatedDist_ = TargetDist_;
+  /*********************/
+  /* Shared-mem Stats  */
+  /*********************/
+  if (enableConsoleOutput_) {
+    stats_.reset(new StatsShm::StatsWriter("stc" + std::to_string(index_)));
+  }
 
   /**********************************/
   /* Control & Communication Thread */
   /**********************************/
+  laneDetectThread_ = std::thread(&ScaleTruckController::lateralLoop, this);
+  objectDetectThread_ = std::thread(&ScaleTruckController::longitudinalLoop, this);
+  RTUtil::setThreadAttr(laneDetectThread_, laneCore_, rtEnable_ ? lanePrio_ : 0, "stc_lane");
+  RTUtil::setThreadAttr(objectDetectThread_, objectCore_, rtEnable_ ? objectPrio_ : 0, "stc_object");
+
   controlThread_ = std::thread(&ScaleTruckController::spin, this);
   tcpThread_ = std::thread(&ScaleTruckController::reply, this, zmq_data_);
+  RTUtil::setThreadAttr(controlThread_, controlCore_, rtEnable_ ? controlPrio_ : 0, "stc_control");
+  RTUtil::setThreadAttr(tcpThread_, tcpCore_, rtEnable_ ? tcpPrio_ : 0, "stc_tcp");
+  if (rear_camera_) {
+    encoderThread_ = std::thread(&ScaleTruckController::encodeRearImage, this);
+    RTUtil::setThreadAttr(encoderThread_, imageCore_, rtEnable_ ? imagePrio_ : 0, "stc_jpeg");
+  }
+  if (index_ != 0) {  // the FVs get the rear image of their preceding truck
+    decoderThread_ = std::thread(&ScaleTruckController::decodeRearImage, this);
+    RTUtil::setThreadAttr(decoderThread_, imageCore_, rtEnable_ ? imagePrio_ : 0, "stc_jpeg_dec");
+  }
 //  if (index_ == 0){
 //    tcpImgThread_ = std::thread(&ScaleTruckController::requestImage, this, img_data_);
 //  }
@@ -199,126 +257,322 @@ bool ScaleTruckController::getImageStatus(void){
   return imageStatus_;
 }
 
-void* ScaleTruckController::lanedetectInThread() {
-  static int cnt = 10;
-  static bool beta_flag = false;
-  static bool _beta = false;
-  Mat dst;
-  std::vector<Mat>channels;
-  int count = 0;
-  float AngleDegree;
-  {
-    std::scoped_lock lock(rep_mutex_, image_mutex_);
-    //if((!camImageTmp_.empty()) && (cnt != 0) && (TargetVel_ > 0.001f))
-    if((!camImageTmp_.empty()) && (cnt != 0) )
+bool ScaleTruckController::waitForImage(){
+  const auto wait_duration = std::chrono::milliseconds(2000);
+  std::unique_lock<std::mutex> lock(image_mutex_);
+  while(!imageStatus_) {
+    if(!isNodeRunning_) {
+      return false;
+    }
+    if(!image_cv_.wait_for(lock, wait_duration, [this] { return imageStatus_; })) {
+      printf("Waiting for image.\n");
+    }
+  }
+  return true;
+}
+
+/* Lateral control, one lane detection per camera (or LV rear camera) frame */
+void ScaleTruckController::lateralLoop(){
+  double diff_time = 0.0;
+  int cnt = 0;
+  uint32_t frame_seq = 0;
+  const auto wait_image = std::chrono::milliseconds(frameTimeout_);
+
+  if(!waitForImage()) return;
+
+  while(isNodeRunning_ && !controlDone_) {
+    struct timeval start_time, end_time;
+    bool new_frame;
+
     {
-      bitwise_xor(camImageCopy_,camImageTmp_, dst);
-      split(dst, channels);
-      for(int ch = 0; ch<dst.channels();ch++) {
-        count += countNonZero(channels[ch]);
-      }
-      {
-        if(count == 0 && fi_camera_)
-          cnt -= 1;
-        else 
-          cnt = 10;
+      std::unique_lock<std::mutex> lock(image_mutex_);
+      new_frame = image_cv_.wait_for(lock, wait_image, [this, &frame_seq] { return imageSeq_ != frame_seq || !isNodeRunning_; });
+      frame_seq = imageSeq_;
+    }
+    if (!isNodeRunning_) break;
+
+    if (!new_frame) {
+      /* No frame in time: keep the last steering, the longitudinal loop runs on */
+      if (commandState_.load().fi_camera && frozenCnt_ > 0 && --frozenCnt_ == 0) {
+        controlState_.update([](ControlState& state) { state.beta = true; });
       }
+      continue;
+    }
+
+    gettimeofday(&start_time, NULL);
+    cycleMonitor_.begin();
+
+    lanedetectInThread();
+
+    scale_truck_control::xav2lrc msg = xavMessage();  //Xavier to LRC and LRC to OpenCR
+    if(!msg.image_stamp.isZero()) cmdAge_.record((msg.stc_stamp - msg.image_stamp).toSec() * 1000.0);
+    XavPublisher_.publish(msg);
+
+    cycleMonitor_.end();
+    gettimeofday(&end_time, NULL);
+    const double cycle_time = ((end_time.tv_sec - start_time.tv_sec) * 1000.0) + ((end_time.tv_usec - start_time.tv_usec) / 1000.0);
+    diff_time += cycle_time;
+    cnt++;
+    qosLevel_ = qos_.update(cycle_time);
+
+    CycleTime_ = diff_time / (double)cnt;
+
+    if (cnt > 3000){
+      diff_time = 0.0;
+      cnt = 0;
     }
-    camImageTmp_ = camImageCopy_.clone();
   }
+}
 
-  {
-    std::unique_lock<std::mutex> lock(lane_mutex_);
-    std::scoped_lock(bbox_mutex_, vel_mutex_, rear_image_mutex_);
-    cv_.wait(lock, [this] {return droi_ready_; });
+/* Longitudinal control, one gap update per lidar scan */
+void ScaleTruckController::longitudinalLoop(){
+  uint32_t scan_seq = 0;
+  const auto wait_scan = std::chrono::milliseconds((int)(lidarPeriod_ * 2.0));
+  const auto wait_first = std::chrono::milliseconds(2000);
 
-    laneDetector_.name_ = name_;
-    laneDetector_.x_ = x_;
-    laneDetector_.y_ = y_;
-    laneDetector_.h_ = h_;
-    laneDetector_.w_ = w_;
+  // independent of the camera, only the first scan is awaited
+  while(isNodeRunning_ && !controlDone_) {
+    {
+      // on timeout the last scan is reused so target velocity changes still apply
+      std::unique_lock<std::mutex> lock(object_mutex_);
+      scan_cv_.wait_for(lock, scan_seq ? wait_scan : wait_first, [this, &scan_seq] { return scanSeq_ != scan_seq || !isNodeRunning_; });
+      scan_seq = scanSeq_;
+    }
+    if (!isNodeRunning_) break;
+    if (scan_seq == 0) {
+      printf("Waiting for scan.\n");
+      continue;
+    }
 
-    laneDetector_.get_steer_coef(CurVel_);
+    longitudinalMonitor_.begin();
 
-    if(!rearImageJPEG_.empty()) camImageTmp_ = rearImageJPEG_.clone();
+    objectdetectInThread();
 
-    AngleDegree = laneDetector_.display_img(camImageTmp_, waitKeyDelay_, viewImage_);
+    XavPublisher_.publish(xavMessage());
 
-    actAngleDegree_ = AngleDegree;
-    AngleDegree2_ = laneDetector_.SteerAngle2_;
-    droi_ready_ = false;
+    longitudinalMonitor_.end();
   }
+}
 
-  if(cnt == 0){
-    if (!beta_flag) {
-      std::scoped_lock lock(rep_mutex_, lane_mutex_);
-      beta_ = true;
-      laneDetector_.beta_ = true;
-      beta_flag = true;
-      _beta = beta_;
+void* ScaleTruckController::lanedetectInThread() {
+  int& cnt = frozenCnt_;
+  static bool beta_flag = false;
+  Mat dst;
+  std::vector<Mat>channels;
+  int count = 0;
+  float AngleDegree, AngleDegree2;
+  cv_bridge::CvImageConstPtr cam_image;
+  const CommandState cmd = commandState_.load();
+  const BboxState bbox = bboxState_.load();
+  const ControlState ctrl = controlState_.load();
+
+  cameraFrames_.update();
+  cam_image = cameraFrames_.front().image;
+  //if((!camImageTmp_.empty()) && (cnt != 0) && (TargetVel_ > 0.001f))
+  if(cam_image && camImagePrev_ && (cnt != 0) )
+  {
+    bitwise_xor(cam_image->image, camImagePrev_->image, dst);
+    split(dst, channels);
+    for(int ch = 0; ch<dst.channels();ch++) {
+      count += countNonZero(channels[ch]);
     }
+    if(count == 0 && cmd.fi_camera)
+      cnt -= 1;
+    else 
+      cnt = 10;
   }
+  camImagePrev_ = cam_image;
+  if(cam_image) camImageTmp_ = cam_image->image;
   {
-    std::scoped_lock lock(rep_mutex_, dist_mutex_);
-    if (!_beta) {
-      AngleDegree_ = AngleDegree;
+    std::scoped_lock lock(rear_image_mutex_);
+    if(!rearImageJPEG_.empty()) camImageTmp_ = rearImageJPEG_;
+  }
+
+  /* YOLO only refreshes the box, the tracker follows it in between */
+  BboxState box = bbox;
+  if(ctrl.gamma && bboxTrackerEnable_ && !camImageTmp_.empty()) {
+    if(!bboxTracking_) {
+      // YOLO was off before gamma, wait for a box it sends from now on
+      bboxTracking_ = true;
+      bboxSeq_ = box.seq;
+      bboxTracker_.reset();
+    }
+    trackBox(camImageTmp_, &box);
+    requestYolo(bboxTracker_.needDetection());
+  }
+  else {
+    bboxTracking_ = false;
+    requestYolo(ctrl.gamma);
+  }
+
+  laneDetector_.name_ = box.name;
+  laneDetector_.x_ = box.x;
+  laneDetector_.y_ = box.y;
+  laneDetector_.h_ = box.h;
+  laneDetector_.w_ = box.w;
+  laneDetector_.beta_ = ctrl.beta;
+  laneDetector_.gamma_ = ctrl.gamma;
+  laneDetector_.qos_level_ = qosLevel_;
+
+  laneDetector_.get_steer_coef(cmd.cur_vel);
+
+  laneDetector_.distance_ = droiDistance_.load();  // latest value from the longitudinal loop
+
+  AngleDegree = laneDetector_.display_img(camImageTmp_, waitKeyDelay_, viewImage_);
+  AngleDegree2 = laneDetector_.SteerAngle2_;
+
+  LaneState lane;
+  lane.coef[0].a = laneDetector_.lane_coef_.left.a;
+  lane.coef[0].b = laneDetector_.lane_coef_.left.b;
+  lane.coef[0].c = laneDetector_.lane_coef_.left.c;
+  lane.coef[1].a = laneDetector_.lane_coef_.right.a;
+  lane.coef[1].b = laneDetector_.lane_coef_.right.b;
+  lane.coef[1].c = laneDetector_.lane_coef_.right.c;
+  lane.coef[2].a = laneDetector_.lane_coef_.center.a;
+  lane.coef[2].b = laneDetector_.lane_coef_.center.b;
+  lane.coef[2].c = laneDetector_.lane_coef_.center.c;
+  lane.y_offset = laneDetector_.y_offset_;
+  lane.est_dist = laneDetector_.est_dist_;
+  if(laneDetector_.est_seq_ != estSeq_ && cam_image) {
+    estSeq_ = laneDetector_.est_seq_;
+    distFusion_.push(DistFusion::CAMERA, cam_image->header.stamp.isZero() ? ros::Time::now() : cam_image->header.stamp, lane.est_dist);
+  }
+  lane.K1 = laneDetector_.K1_;
+  lane.K2 = laneDetector_.K2_;
+  lane.box_conf = bboxTracker_.confidence();
+  lane.box_frames = bboxTracker_.framesSinceDetection();
+  if(cam_image) {
+    lane.image_stamp = cam_image->header.stamp;
+    if(!lane.image_stamp.isZero()) laneAge_.record((ros::Time::now() - lane.image_stamp).toSec() * 1000.0);
+  }
+  else {
+    lane.image_stamp = laneState_.load().image_stamp;
+  }
+  laneState_.store(lane);
+
+  bool latch_beta = false;
+  if(cnt == 0 && !beta_flag){
+    latch_beta = true;
+    beta_flag = true;
+  }
+  const bool head = (strcmp(bbox.name, "head") == 0);
+  controlState_.update([&](ControlState& state) {
+    if (latch_beta) {
+      state.beta = true;
+    }
+    if (!state.beta) {
+      state.angle_degree = AngleDegree;
     }
-    else if (_beta && gamma_ && name_ == "head"){
-      AngleDegree_ = AngleDegree2_;
-//      AngleDegree_ = ampersand2_;
-//      printf("TW's Algorithm!!");
-      
+    else if (state.gamma && head){
+      state.angle_degree = AngleDegree2;
     }
     else { //pure pursuit angle
-      AngleDegree_ = distAngle_;
+      state.angle_degree = state.dist_angle;
     }
+  });
+
+  return nullptr;
+}
+
+/* Seeds the tracker only from YOLO boxes newer than the last one used. A lost
+ * track gives an empty box (no camera gap) until YOLO answers again */
+void ScaleTruckController::trackBox(const cv::Mat& frame, BboxState* box) {
+  if((int32_t)(box->seq - bboxSeq_) > 0) {
+    bboxSeq_ = box->seq;
+    bboxTracker_.init(frame, cv::Rect(box->x, box->y, box->w, box->h));
+    return;
+  }
+
+  cv::Rect rect;
+  if(bboxTracker_.update(frame, &rect)) {
+    box->x = rect.x;
+    box->y = rect.y;
+    box->w = rect.width;
+    box->h = rect.height;
+  }
+  else {
+    box->x = box->y = box->w = box->h = 0;
   }
+}
+
+/* lateral loop only, publishes on change */
+void ScaleTruckController::requestYolo(bool run) {
+  if(run == run_yolo_) return;
 
+  scale_truck_control::yolo_flag yolo_flag_msg;
+  run_yolo_ = run;
+  yolo_flag_msg.run_yolo = run;
+  runYoloPublisher_.publish(yolo_flag_msg);
 }
 
 void* ScaleTruckController::objectdetectInThread() {
   float Lw = Lw_; // 0.236 0.288 0.340 
   float dist, Ld, angle, angle_A;
   float dist_tmp, angle_tmp, theta_;
+  int obj_circles, droi_distance;
   dist_tmp = 10.1f; 
   Point center_;
   Point2d normalize_;
   Point3d LV3D_, FV3D_;
+  const CommandState cmd = commandState_.load();
+  const LaneState lane = laneState_.load();
+  const BboxState bbox = bboxState_.load();
+  ControlState ctrl = controlState_.load();
+  angle_tmp = ctrl.dist_angle;
   /**************/
   /* Lidar Data */
   /**************/
+  obstacle_detector::Obstacles::ConstPtr scan;
   {
-    std::scoped_lock lock(lane_mutex_, object_mutex_);
-    ObjSegments_ = Obstacle_.segments.size();
-    ObjCircles_ = Obstacle_.circles.size();
-  
-    for(int i = 0; i < ObjCircles_; i++)
-    {
-      //dist = sqrt(pow(Obstacle_.circles[i].center.x,2)+pow(Obstacle_.circles[i].center.y,2));
-      dist = -Obstacle_.circles[i].center.x - Obstacle_.circles[i].true_radius;
-      angle = atanf(Obstacle_.circles[i].center.y/Obstacle_.circles[i].center.x)*(180.0f/M_PI);
-      if(dist_tmp >= dist) {
-        dist_tmp = dist;
-        angle_tmp = angle;
-	x_coord_ = dist_tmp;
-	y_coord_ = Obstacle_.circles[i].center.y + laneDetector_.y_offset_; // correction to lane center
-      }
-    }
-    Ld = sqrt(pow(x_coord_+Lw, 2) + pow(y_coord_, 2)) + Ld_offset_;
-    angle_A = atanf(y_coord_/(x_coord_+Lw));
-    ampersand_ = atanf(2*Lw*sin(angle_A)/Ld) * (180.0f/M_PI); // pure pursuit
-    ppAngle_ = ampersand_;
-  } 
-  actDist_ = dist_tmp;
-  {
-    std::scoped_lock lock(lane_mutex_);
-    if(gamma_ == true && laneDetector_.est_dist_ != 0){
-      dist_tmp = laneDetector_.est_dist_;
-      estimatedDist_ = dist_tmp;
-    }
-    if(beta_ == true){
-      angle_tmp = ppAngle_;
-    }
+    std::scoped_lock lock(object_mutex_);
+    scan = Obstacle_;
+  }
+  obj_circles = 0;
+  if(scan) {
+    ObjSegments_ = scan->segments.size();
+    obj_circles = scan->circles.size();
+    ctrl.scan_stamp = scan->header.stamp;
+  }
+
+  // a timeout reuses the last scan, the track is only predicted forward
+  const bool new_scan = (scan != trackedScan_);
+  const VehicleTracker::Track& track = new_scan ? tracker_.update(scan) : tracker_.track();
+  trackedScan_ = scan;
+  if(track.valid) {
+    if(new_scan) distFusion_.push(DistFusion::LIDAR, track.stamp, track.range);
+    angle_tmp = track.angle;
+    ctrl.x_coord = track.range;
+    ctrl.y_coord = track.lateral + lane.y_offset; // correction to lane center
+  }
+  Ld = sqrt(pow(ctrl.x_coord+Lw, 2) + pow(ctrl.y_coord, 2)) + Ld_offset_;
+  angle_A = atanf(ctrl.y_coord/(ctrl.x_coord+Lw));
+  ampersand_ = atanf(2*Lw*sin(angle_A)/Ld) * (180.0f/M_PI); // pure pursuit
+  ppAngle_ = ampersand_;
+  ctrl.act_dist = track.valid ? track.range : dist_tmp;
+  ctrl.obj_circles = obj_circles;
+  ctrl.rel_vel = track.valid ? track.range_rate : 0.0f;
+
+  /*******************/
+  /* Distance Fusion */
+  /*******************/
+  // both gaps are brought to the same control time, a failing sensor fades out
+  distFusion_.setHealthy(DistFusion::LIDAR, track.valid && !ctrl.gamma && !cmd.fi_lidar);
+  distFusion_.setHealthy(DistFusion::CAMERA, lane.est_dist != 0 && !cmd.fi_camera);
+  const DistFusion::Result fused = distFusion_.fuse(ros::Time::now());
+  if(fused.valid) {
+    dist_tmp = fused.dist;
+    if(fused.weight[DistFusion::LIDAR] > 0.0f) scanFuseAge_.record(fused.age[DistFusion::LIDAR] * 1000.0);
+    if(fused.weight[DistFusion::CAMERA] > 0.0f) cameraFuseAge_.record(fused.age[DistFusion::CAMERA] * 1000.0);
+  }
+  ctrl.lidar_weight = fused.weight[DistFusion::LIDAR];
+  ctrl.tracked = track.valid && fused.weight[DistFusion::LIDAR] > 0.5f;
+
+  if(ctrl.gamma == true && lane.est_dist != 0){
+    ctrl.est_dist = lane.est_dist;
+  }
+  if(ctrl.beta == true){
+    angle_tmp = ppAngle_;
+  }
 //    
 //    if(gamma_ == true && beta_ == true && laneDetector_.est_dist_ != 0){
 //      dist_tmp = laneDetector_.est_dist_;
@@ -347,64 +601,101 @@ void* ScaleTruckController::objectdetectInThread() {
 //      printf("\nFV3D : (%.3lf, %.3lf)", FV3D_.x, FV3D_.z);
 //      printf("\nLd : (%.3lf)", Ld);
 //    }
-  }
 
-  if(ObjCircles_ != 0)
+  /* no fused gap: a working lidar answers alone (track, held gap while confirming,
+   * or "no object" for a clear lane), otherwise the gap is unknown */
+  const bool lidar_ok = scan && !ctrl.gamma && !cmd.fi_lidar;
+  ctrl.dist_valid = true;
+  if(!fused.valid) {
+    if(lidar_ok && track.valid) {
+      dist_tmp = tracker_.predictRange(ros::Time::now());
+    }
+    else if(lidar_ok && track.hits > 0) {
+      dist_tmp = ctrl.distance;  // candidate short of confirm_hits, hold the last gap instead of "no object"
+    }
+    else if(!lidar_ok) {
+      ctrl.dist_valid = false;  // dist_tmp stays "no object" for the dynamic ROI only
+    }
+  }
+  if(ctrl.dist_valid)
   {
-    std::scoped_lock lock(dist_mutex_);
-    distance_ = dist_tmp;
-    distAngle_ = angle_tmp;
+    ctrl.distance = dist_tmp;
+    ctrl.dist_angle = angle_tmp;
   }
 
   /*****************************/
   /* Dynamic ROI Distance Data */
   /*****************************/
+  if(dist_tmp < 1.24f && dist_tmp > 0.30f) // 1.26 ~ 0.28
   {
-    std::scoped_lock lock(rep_mutex_, lane_mutex_);
-    if(dist_tmp < 1.24f && dist_tmp > 0.30f) // 1.26 ~ 0.28
-    {
-      if (beta_ == true || (gamma_ == true && laneDetector_.est_dist_ != 0 && name_ == "head")){
-        laneDetector_.distance_ = (int)((1.35f - dist_tmp)*480.0f)+25;
-      }
-      else {
-        laneDetector_.distance_ = (int)((1.24f - dist_tmp)*490.0f)+20;
-      }
+    if (ctrl.beta == true || (ctrl.gamma == true && lane.est_dist != 0 && strcmp(bbox.name, "head") == 0)){
+      droi_distance = (int)((1.35f - dist_tmp)*480.0f)+25;
     }
     else {
-      laneDetector_.distance_ = 0;
+      droi_distance = (int)((1.24f - dist_tmp)*490.0f)+20;
     }
-    droi_ready_ = true;
-    cv_.notify_one();
   }
-  if(index_ == 0){  //LV
-    std::scoped_lock lock(rep_mutex_, dist_mutex_);
-    if(distance_ <= LVstopDist_) {
+  else {
+    droi_distance = 0;
+  }
+  droiDistance_ = droi_distance;
+
+  float result_vel = ctrl.result_vel;
+  if(!ctrl.dist_valid){
+    // neither sensor has a gap: the FVs stop, the LV holds the safety velocity
+    result_vel = (index_ == 0) ? std::min(cmd.tar_vel, SafetyVel_) : 0.0f;
+  }
+  else if(index_ == 0){  //LV
+    if(ctrl.distance <= LVstopDist_) {
     // Emergency Brake
-      ResultVel_ = 0.0f;
+      result_vel = 0.0f;
     }
-    else if (distance_ <= SafetyDist_){
-      float TmpVel_ = (ResultVel_-SafetyVel_)*((distance_-LVstopDist_)/(SafetyDist_-LVstopDist_))+SafetyVel_;
-      if (TargetVel_ < TmpVel_){
-        ResultVel_ = TargetVel_;
+    else if (ctrl.distance <= SafetyDist_){
+      float TmpVel_ = (result_vel-SafetyVel_)*((ctrl.distance-LVstopDist_)/(SafetyDist_-LVstopDist_))+SafetyVel_;
+      if (cmd.tar_vel < TmpVel_){
+        result_vel = cmd.tar_vel;
       }
       else{
-        ResultVel_ = TmpVel_;
+        result_vel = TmpVel_;
       }
     }
     else{
-      ResultVel_ = TargetVel_;
+      result_vel = cmd.tar_vel;
     }
   }
   else{  //FVs
-    std::scoped_lock lock(rep_mutex_, dist_mutex_);
-    if ((distance_ <= FVstopDist_) || (TargetVel_ <= 0.1f)){
+    if ((ctrl.distance <= FVstopDist_) || (cmd.tar_vel <= 0.1f)){
     // Emergency Brake
-      ResultVel_ = 0.0f;
+      result_vel = 0.0f;
     }
     else {
-      ResultVel_ = TargetVel_;
+      result_vel = cmd.tar_vel;
     }
   }
+
+  /* beta and gamma belong to other writers */
+  const bool head = (strcmp(bbox.name, "head") == 0);
+  controlState_.update([&](ControlState& state) {
+    state.result_vel = result_vel;
+    state.distance = ctrl.distance;
+    state.dist_valid = ctrl.dist_valid;
+    state.dist_angle = ctrl.dist_angle;
+    state.act_dist = ctrl.act_dist;
+    state.est_dist = ctrl.est_dist;
+    state.x_coord = ctrl.x_coord;
+    state.y_coord = ctrl.y_coord;
+    state.obj_circles = ctrl.obj_circles;
+    state.scan_stamp = ctrl.scan_stamp;
+    state.rel_vel = ctrl.rel_vel;
+    state.tracked = ctrl.tracked;
+    state.lidar_weight = ctrl.lidar_weight;
+    state.distance_stamp = ros::Time::now();
+    if (state.beta && !(state.gamma && head)) { //pure pursuit angle, no camera needed
+      state.angle_degree = state.dist_angle;
+    }
+  });
+
+  return nullptr;
 }
 
 void ScaleTruckController::imageCompress(cv::Mat camImage, std::vector<uchar> *compImage) {
@@ -414,156 +705,249 @@ void ScaleTruckController::imageCompress(cv::Mat camImage, std::vector<uchar> *c
   cv::imencode(".jpg", camImage, *compImage, comp);
 }
 
-void ScaleTruckController::requestImage(ImgData* img_data)
+/* Encodes each new rear frame once, only while a follower wants the images */
+void ScaleTruckController::encodeRearImage()
 {
+  uint32_t rear_seq = 0;
+  uint32_t skipped = 0;
+  const auto wait_frame = std::chrono::milliseconds(100);
+
   while(isNodeRunning_){
+    cv_bridge::CvImageConstPtr rear_image;
+    {
+      std::unique_lock<std::mutex> lock(rear_image_mutex_);
+      rear_cv_.wait_for(lock, wait_frame, [this, &rear_seq] { return rearSeq_ != rear_seq || !isNodeRunning_; });
+      if(rearSeq_ == rear_seq) continue;
+      rear_seq = rearSeq_;
+      rear_image = rearImage_;
+    }
+    if(!rear_image || !commandState_.load().send_rear_camera_image) continue;
+    if(qosLevel_ >= LaneDetect::QOS_REDUCED_RATE && (++skipped & 1)) continue;
+
+    auto jpeg = std::make_shared<std::vector<uchar>>();
+    imageCompress(rear_image->image, jpeg.get());
     {
       std::scoped_lock lock(rear_image_mutex_);
-      rearImageTmp_ = rearImageCopy_;
+      compImageSend_ = jpeg;
+      jpegSeq_++;
     }
-    if(!rearImageTmp_.empty()){
-      imageCompress(rearImageTmp_, &compImageSend_);
-      if(compImageSend_.size() <= (sizeof(img_data->comp_image) / sizeof(u_char))){
-        std::copy(compImageSend_.begin(), compImageSend_.end(), img_data->comp_image);
-      }
-      else printf("Warning !! compressed image size is bigger than comp_img array size in ImgData\n");
-      img_data->size = compImageSend_.size();
-      req_check_++;
-      gettimeofday(&img_data->startTime, NULL);
-      ZMQ_SOCKET_.requestImageZMQ(img_data, backup_data_); 
-    }
-    printf("image request socket change count: %d\n", ZMQ_SOCKET_.img_socket_change_count_);
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-  } 
+    jpeg_cv_.notify_all();
+  }
 }
 
-void ScaleTruckController::replyImage()
+void ScaleTruckController::requestImage(ImgData* img_data)
 {
-  while(isNodeRunning_){
-    struct timeval endTime;
-    ZMQ_SOCKET_.replyImageZMQ();
-    img_data_ = ZMQ_SOCKET_.img_recv_;
-    compImageRecv_.resize(img_data_->size);
-    memcpy(&compImageRecv_[0], &img_data_->comp_image[0], img_data_->size);
+  uint32_t jpeg_seq = 0;
+  const auto wait_jpeg = std::chrono::milliseconds(100);
 
+  while(isNodeRunning_){
+    std::shared_ptr<const std::vector<uchar>> jpeg;
     {
-      std::scoped_lock lock(rear_image_mutex_);
-      rearImageJPEG_ = imdecode(Mat(compImageRecv_), IMREAD_COLOR);
-      //image publish
-      sensor_msgs::ImagePtr msg = cv_bridge::CvImage(std_msgs::Header(), "bgr8", rearImageJPEG_).toImageMsg();
-      msg->header.stamp.sec = img_data_->startTime.tv_sec;
-      msg->header.stamp.nsec = img_data_->startTime.tv_usec;
-      imgPublisher_.publish(msg);
+      std::unique_lock<std::mutex> lock(rear_image_mutex_);
+      jpeg_cv_.wait_for(lock, wait_jpeg, [this, &jpeg_seq] { return jpegSeq_ != jpeg_seq || !isNodeRunning_; });
+      if(jpegSeq_ == jpeg_seq) continue;
+      if(jpeg_seq) jpegSkipped_ += jpegSeq_ - jpeg_seq - 1;  //encoded while the last one was in flight
+      jpeg_seq = jpegSeq_;
+      jpeg = compImageSend_;
     }
+    if(!jpeg) continue;
 
-    gettimeofday(&endTime, NULL);
-    rep_check_++;
-    if (rep_check_ > 0) time_ += ((endTime.tv_sec - img_data_->startTime.tv_sec) * 1000.0) + ((endTime.tv_usec - img_data_->startTime.tv_usec)/1000.0);
-    else time_ = 0.0;
+    req_check_++;
+    gettimeofday(&img_data->startTime, NULL);
 
-    DelayTime_ = time_ / (double)rep_check_;
+    ZMQ_SOCKET_.sendImageZMQ(img_data, jpeg);  //a lost frame is not resent, the next one is newer
+  } 
+}
 
-    if (rep_check_ > 3000){
-      time_ = 0.0;
-      rep_check_ = 0;
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+/* Runs on the ZMQ reactor per image from the preceding truck. Only the JPEG is
+ * copied out of the frame, decoding would hold up the commands behind it */
+void ScaleTruckController::replyImage(ImgData* img_data)
+{
+  auto jpeg = std::make_shared<std::vector<uchar>>(img_data->comp_image, img_data->comp_image + img_data->size);
+  {
+    std::scoped_lock lock(rear_image_mutex_);
+    if(compImageRecv_) recvSkipped_++;
+    compImageRecv_ = jpeg;
+    imgRecv_ = *img_data;
+    imgRecv_.comp_image = nullptr;
+    recvSeq_++;
   }
+  decode_cv_.notify_one();
 }
 
-void ScaleTruckController::reply(ZmqData* zmq_data){
+/* Decodes and publishes the newest received rear image, older ones are dropped */
+void ScaleTruckController::decodeRearImage()
+{
+  uint32_t recv_seq = 0;
+  const auto wait_jpeg = std::chrono::milliseconds(100);
+
   while(isNodeRunning_){
-    static float t_vel = 0.0f;
-    static float t_dist = 0.8f;
-    if(zmq_data->tar_index == 20){
-      {
-        std::scoped_lock lock(vel_mutex_, dist_mutex_);
-	zmq_data->cur_vel = CurVel_;
-	zmq_data->cur_dist = actDist_;
-	zmq_data->cur_angle = AngleDegree_;
-      }
-      {
-        std::scoped_lock lock(lane_mutex_);
-        zmq_data->coef[0].a = laneDetector_.lane_coef_.left.a;
-        zmq_data->coef[0].b = laneDetector_.lane_coef_.left.b;
-        zmq_data->coef[0].c = laneDetector_.lane_coef_.left.c;
-        zmq_data->coef[1].a = laneDetector_.lane_coef_.right.a;
-        zmq_data->coef[1].b = laneDetector_.lane_coef_.right.b;
-        zmq_data->coef[1].c = laneDetector_.lane_coef_.right.c;
-        zmq_data->coef[2].a = laneDetector_.lane_coef_.center.a;
-        zmq_data->coef[2].b = laneDetector_.lane_coef_.center.b;
-        zmq_data->coef[2].c = laneDetector_.lane_coef_.center.c;
-      }
-      ZMQ_SOCKET_.replyZMQ(zmq_data);
-    }
+    std::shared_ptr<const std::vector<uchar>> jpeg;
+    ImgData img_data;
     {
-      std::scoped_lock lock(rep_mutex_, mode_mutex_);
-      if(index_ == 0){
-        if(crc_mode_ == 2){
-          TargetVel_ = 0;
-	}
-	else if(crc_mode_ == 1){
-          if(t_vel > RCMVel_) TargetVel_ = RCMVel_;
-          else TargetVel_ = t_vel;
-	  if(t_dist < RCMDist_) TargetDist_ = RCMDist_;
-	  else TargetDist_ = t_dist;
-	}
-      }
-      if(ZMQ_SOCKET_.rep_recv_->src_index == 20){
-        if(index_ == 0){  //LV 
-          t_vel = ZMQ_SOCKET_.rep_recv_->tar_vel;
-          t_dist = ZMQ_SOCKET_.rep_recv_->tar_dist;
-	  if(crc_mode_ == 1){  //RCM
-            if (t_vel > RCMVel_) TargetVel_ = RCMVel_;
-	    else TargetVel_ = t_vel;
-	    if (t_dist < RCMDist_) TargetDist_ = RCMDist_;
-	    else TargetDist_ = t_dist;
-	  }
-	  else{  //TM
-            TargetVel_ = t_vel;
-            TargetDist_ = t_dist;
-	  }
-	}
-        fi_encoder_ = ZMQ_SOCKET_.rep_recv_->fi_encoder;
-        fi_camera_ = ZMQ_SOCKET_.rep_recv_->fi_camera;
-        fi_lidar_ = ZMQ_SOCKET_.rep_recv_->fi_lidar;
-        alpha_ = ZMQ_SOCKET_.rep_recv_->fi_encoder;
-      }
+      std::unique_lock<std::mutex> lock(rear_image_mutex_);
+      decode_cv_.wait_for(lock, wait_jpeg, [this, &recv_seq] { return recvSeq_ != recv_seq || !isNodeRunning_; });
+      if(recvSeq_ == recv_seq) continue;
+      recv_seq = recvSeq_;
+      jpeg.swap(compImageRecv_);
+      img_data = imgRecv_;
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    if(!jpeg) continue;
+    decodeImage(*jpeg, &img_data);
   }
 }
 
-void ScaleTruckController::displayConsole() {
-  static std::string ipAddr = ZMQ_SOCKET_.getIPAddress();
+void ScaleTruckController::decodeImage(const std::vector<uchar>& jpeg, ImgData* img_data)
+{
+  struct timeval endTime;
+  Mat rear_image = imdecode(jpeg, IMREAD_COLOR);
+  if(rear_image.empty()) return;
+
+  {
+    std::scoped_lock lock(rear_image_mutex_);
+    rearImageJPEG_ = rear_image;
+  }
+  //image publish
+  sensor_msgs::ImagePtr msg = cv_bridge::CvImage(std_msgs::Header(), "bgr8", rear_image).toImageMsg();
+  msg->header.stamp.sec = img_data->startTime.tv_sec;
+  msg->header.stamp.nsec = img_data->startTime.tv_usec * 1000;
+  imgPublisher_.publish(msg);
+  {
+    // the lane thread runs on this image once the front camera is gone
+    std::scoped_lock lock(image_mutex_);
+    imageSeq_++;
+  }
+  image_cv_.notify_all();
+
+  if(!img_data->clock_synced) return;  //the sender's stamp, not comparable with our clock yet
+  gettimeofday(&endTime, NULL);
+  rep_check_++;
+  if (rep_check_ > 0) time_ += ((endTime.tv_sec - img_data->startTime.tv_sec) * 1000.0) + ((endTime.tv_usec - img_data->startTime.tv_usec)/1000.0);
+  else time_ = 0.0;
 
-  printf("\033[2J");
-  printf("\033[1;1H");
-  printf("%s (%s) - %s\n","-Client", ipAddr.c_str() , ZMQ_SOCKET_.udp_ip_.c_str());
-  printf("\nAngle\t\t\t: %2.3f degree", AngleDegree_);
-  printf("\nRefer Vel\t\t: %3.3f m/s", RefVel_);
-  printf("\nSend Vel\t\t: %3.3f m/s", ResultVel_);
-  printf("\nTar/Cur Vel\t\t: %3.3f / %3.3f m/s", TargetVel_, CurVel_);
-  printf("\nTar/Cur/Est Dist\t\t: %3.3f / %3.3f / %3.3f m", TargetDist_, distance_, estimatedDist_);
-  printf("\nEncoder, Camera, Lidar Failure: %d / %d / %d", fi_encoder_, fi_camera_, fi_lidar_);
-  printf("\nAlpha, Beta, Gamma\t: %d / %d / %d", alpha_, beta_, gamma_);
-  printf("\nCRC mode, LRC mode\t: %d / %d", crc_mode_, lrc_mode_);
-  printf("\nK1/K2\t\t\t: %3.3f / %3.3f", laneDetector_.K1_, laneDetector_.K2_);
-  printf("\nLdrErrMsg\t\t\t: %x", LdrErrMsg_);
-  printf("\nx / y / w / h\t\t: %u / %u / %u / %u", x_, y_, w_, h_);
-  printf("\nREQ Check\t\t: %d", req_check_);
-  printf("\nREP Check\t\t: %d", rep_check_);
-  if(!compImageSend_.empty()){
-    printf("\nSending image size\t: %zu", compImageSend_.size());
-  }
-  printf("\nCycle Time\t\t: %3.3f ms", CycleTime_);
-  if(ObjCircles_ > 0) {
-    printf("\nCirs\t\t\t: %d", ObjCircles_);
-    printf("\nDistAng\t\t\t: %2.3f degree", distAngle_);
-    printf("\nObject\t\t\t: [%.2f,%.2f]", x_coord_, y_coord_); 
-  }
-  printf("\nampersandt\t\t: %2.3f degree", ampersand2_); 
-  printf("\n");
+  DelayTime_ = time_ / (double)rep_check_;
+
+  if (rep_check_ > 3000){
+    time_ = 0.0;
+    rep_check_ = 0;
+  }
+}
+
+/* ZMQ reactor thread: telemetry to the control center, its commands and the rear image */
+void ScaleTruckController::reply(ZmqData* zmq_data){
+  ZMQ_SOCKET_.onReply(zmq_data,
+    [this](ZmqData* data) {
+      const CommandState cmd = commandState_.load();
+      const ControlState ctrl = controlState_.load();
+      const LaneState lane = laneState_.load();
+      data->cur_vel = cmd.cur_vel;
+      data->cur_dist = ctrl.act_dist;
+      data->cur_angle = ctrl.angle_degree;
+      data->qos_level = qosLevel_;
+      for(int i = 0; i < 3; i++){
+        data->coef[i] = lane.coef[i];
+      }
+      data->image_stamp.tv_sec = lane.image_stamp.sec;
+      data->image_stamp.tv_usec = lane.image_stamp.nsec / 1000;
+    },
+    [this](ZmqData* data) { applyCommand(data); });
+  ZMQ_SOCKET_.onImage([this](ImgData* img_data) { if (req_lv_) replyImage(img_data); });
+
+  ZMQ_SOCKET_.spin();
+}
+
+/* LV target from the control center, limited while the CRC runs RCM / GDM */
+void ScaleTruckController::applyCrcMode(CommandState& cmd){
+  if(cmd.crc_mode == 2){  //GDM
+    cmd.tar_vel = 0;
+  }
+  else if(cmd.crc_mode == 1){  //RCM
+    if (cmd.cc_vel > RCMVel_) cmd.tar_vel = RCMVel_;
+    else cmd.tar_vel = cmd.cc_vel;
+    if (cmd.cc_dist < RCMDist_) cmd.tar_dist = RCMDist_;
+    else cmd.tar_dist = cmd.cc_dist;
+  }
+  else{  //TM
+    cmd.tar_vel = cmd.cc_vel;
+    cmd.tar_dist = cmd.cc_dist;
+  }
+}
+
+void ScaleTruckController::applyCommand(ZmqData* zmq_data){
+  if(zmq_data->src_index != 20) return;
+
+  commandState_.update([&](CommandState& cmd) {
+    if(index_ == 0){  //LV 
+      cmd.cc_vel = zmq_data->tar_vel;
+      cmd.cc_dist = zmq_data->tar_dist;
+      applyCrcMode(cmd);
+    }
+    cmd.fi_encoder = zmq_data->fi_encoder;
+    cmd.fi_camera = zmq_data->fi_camera;
+    cmd.fi_lidar = zmq_data->fi_lidar;
+    cmd.alpha = zmq_data->fi_encoder;
+  });
+}
+
+/* Status page for stc_top, formatted here but never written to stdout */
+void ScaleTruckController::updateStats() {
+  static std::string ipAddr = ZMQ_SOCKET_.getIPAddress();
+  const CommandState cmd = commandState_.load();
+  const ControlState ctrl = controlState_.load();
+  const LaneState lane = laneState_.load();
+  const BboxState bbox = bboxState_.load();
+  char title[64];
+
+  snprintf(title, sizeof(title), "STC %d (%s) - %s", index_, ipAddr.c_str(), ZMQ_SOCKET_.udp_ip_.c_str());
+  stats_->begin(title);
+  stats_->printf("Angle\t\t\t: %2.3f degree", ctrl.angle_degree);
+  stats_->printf("Refer Vel\t\t: %3.3f m/s", RefVel_);
+  stats_->printf("Send Vel\t\t: %3.3f m/s", ctrl.result_vel);
+  stats_->printf("Tar/Cur Vel\t\t: %3.3f / %3.3f m/s", cmd.tar_vel, cmd.cur_vel);
+  stats_->printf("Tar/Cur/Est Dist\t: %3.3f / %3.3f / %3.3f m", cmd.tar_dist, ctrl.distance, ctrl.est_dist);
+  stats_->printf("Encoder, Camera, Lidar Failure: %d / %d / %d", cmd.fi_encoder, cmd.fi_camera, cmd.fi_lidar);
+  stats_->printf("Alpha, Beta, Gamma\t: %d / %d / %d", cmd.alpha, ctrl.beta, ctrl.gamma);
+  stats_->printf("CRC mode, LRC mode\t: %d / %d", cmd.crc_mode, cmd.lrc_mode);
+  stats_->printf("K1/K2\t\t\t: %3.3f / %3.3f", lane.K1, lane.K2);
+  stats_->printf("LdrErrMsg\t\t: %x", LdrErrMsg_);
+  stats_->printf("x / y / w / h\t\t: %u / %u / %u / %u", bbox.x, bbox.y, bbox.w, bbox.h);
+  stats_->printf("YOLO / Bbox Track\t: %d / %.2f (%d frames)", run_yolo_.load(), lane.box_conf, lane.box_frames);
+  stats_->printf("REQ / REP Check\t\t: %d / %d", req_check_, rep_check_);
+  stats_->printf("Wire Errors\t\t: %u", ZMQ_SOCKET_.wire_errors_.load());
+  std::shared_ptr<const std::vector<uchar>> jpeg;
+  {
+    std::scoped_lock lock(rear_image_mutex_);
+    jpeg = compImageSend_;
+  }
+  if(jpeg){
+    stats_->printf("Sending image size\t: %zu (%u skipped)", jpeg->size(), jpegSkipped_.load());
+  }
+  if(index_ != 0){
+    stats_->printf("Received image\t\t: %u skipped before decoding", recvSkipped_.load());
+  }
+  for(const std::string& line : ZMQ_SOCKET_.healthReport()) stats_->printf("%s", line.c_str());
+  stats_->printf("Cycle Time\t\t: %3.3f ms", CycleTime_);
+  stats_->printf("QoS Level\t\t: %d / %d", qosLevel_.load(), qosMaxLevel_);
+  stats_->printf("%s", cycleMonitor_.summary().c_str());
+  stats_->printf("%s", longitudinalMonitor_.summary().c_str());
+  stats_->printf("%s", cameraAge_.summary().c_str());
+  stats_->printf("%s", laneAge_.summary().c_str());
+  stats_->printf("%s", cmdAge_.summary().c_str());
+  stats_->printf("%s", scanAge_.summary().c_str());
+  stats_->printf("%s", scanFuseAge_.summary().c_str());
+  stats_->printf("%s", cameraFuseAge_.summary().c_str());
+  stats_->printf("%s", lrcAge_.summary().c_str());
+  stats_->printf("%s", brakeAge_.summary().c_str());
+  stats_->printf("Track\t\t\t: %s %.3f m%s, %.3f m/s", ctrl.tracked ? "locked" : "none", ctrl.distance, ctrl.dist_valid ? "" : " (no gap)", ctrl.rel_vel);
+  stats_->printf("Fusion lidar/camera\t: w %.2f / %.2f, health %.2f / %.2f", ctrl.lidar_weight, 1.0f - ctrl.lidar_weight, distFusion_.health(DistFusion::LIDAR), distFusion_.health(DistFusion::CAMERA));
+  stats_->printf("Emergency Brake\t\t: %d (%u times, %u over %.0f ms)", emergencyBrake_.load(), brakeCnt_.load(), brakeLate_.load(), lidarPeriod_);
+  if(ctrl.obj_circles > 0) {
+    stats_->printf("Cirs\t\t\t: %d", ctrl.obj_circles);
+    stats_->printf("DistAng\t\t\t: %2.3f degree", ctrl.dist_angle);
+    stats_->printf("Object\t\t\t: [%.2f,%.2f]", ctrl.x_coord, ctrl.y_coord); 
+  }
+  stats_->printf("ampersandt\t\t: %2.3f degree", ampersand2_); 
+  stats_->commit();
 }
 
 void ScaleTruckController::recordData(struct timeval startTime){
@@ -594,10 +978,11 @@ void ScaleTruckController::recordData(struct timeval startTime){
     flag = true;
   }
   if(flag){
-    std::scoped_lock lock(dist_mutex_);
+    const CommandState cmd = commandState_.load();
+    const ControlState ctrl = controlState_.load();
     gettimeofday(&currentTime, NULL);
     diff_time = ((currentTime.tv_sec - startTime.tv_sec)) + ((currentTime.tv_usec - startTime.tv_usec)/1000000.0);
-    sprintf(buf, "%.10e,%.3f,%.3f,%d", diff_time, TargetVel_, AngleDegree_, beta_);
+    sprintf(buf, "%.10e,%.3f,%.3f,%d", diff_time, cmd.tar_vel, ctrl.angle_degree, ctrl.beta);
     write_file.open(file, std::ios::out | std::ios::app);
     write_file << buf << endl;
   }
@@ -605,66 +990,20 @@ void ScaleTruckController::recordData(struct timeval startTime){
 }
 
 void ScaleTruckController::spin() {
-  double diff_time=0.0;
-  int cnt = 0;
-  
-  const auto wait_duration = std::chrono::milliseconds(2000);
-  while(!getImageStatus()) {
-    printf("Waiting for image.\n");
-    if(!isNodeRunning_) {
-      return;
-    }
-    std::this_thread::sleep_for(wait_duration);
-  }
-  
-  scale_truck_control::xav2lrc msg;
-  scale_truck_control::yolo_flag yolo_flag_msg;
-  std::thread lanedetect_thread;
-  std::thread objectdetect_thread;
-  
-  const auto wait_image = std::chrono::milliseconds(20);
+  const auto period = std::chrono::milliseconds(statusPeriod_);
 
+  if(!waitForImage()) return;
+  
   while(!controlDone_ && ros::ok()) {
-    struct timeval start_time, end_time;
-    gettimeofday(&start_time, NULL);
+    const auto next = std::chrono::steady_clock::now() + period;
 
     {
-      std::scoped_lock lock(rep_mutex_);
-      if (gamma_ && !run_yolo_){
-        run_yolo_ = true;
-        yolo_flag_msg.run_yolo = true;
-        runYoloPublisher_.publish(yolo_flag_msg);
-      }
-  
-      if (beta_ && !req_lv_){
+      const ControlState ctrl = controlState_.load();
+      if (ctrl.beta && !req_lv_){
         req_lv_ = true;
       }
     }
-
-    lanedetect_thread = std::thread(&ScaleTruckController::lanedetectInThread, this);
-    objectdetect_thread = std::thread(&ScaleTruckController::objectdetectInThread, this);
-    
-    lanedetect_thread.join();
-    objectdetect_thread.join();    
-
-
-    msg.tar_vel = ResultVel_;  //Xavier to LRC and LRC to OpenCR
-    {
-      std::scoped_lock lock(dist_mutex_);
-      msg.steer_angle = AngleDegree_;
-      msg.cur_dist = distance_;
-    }
-    {
-      std::scoped_lock lock(rep_mutex_);
-      msg.tar_dist = TargetDist_;
-      msg.fi_encoder = fi_encoder_;
-      msg.fi_camera = fi_camera_;
-      msg.fi_lidar = fi_lidar_;
-      msg.alpha = alpha_;
-      msg.beta = beta_;
-      msg.gamma = gamma_;
-    }
-    XavPublisher_.publish(msg);
+    const CommandState cmd = commandState_.load();
 
     if(!isNodeRunning_) {
       controlDone_ = true;
@@ -672,89 +1011,144 @@ void ScaleTruckController::spin() {
       ros::requestShutdown();
     }
 
-    if (!tcp_img_req_ && send_rear_camera_image_ && (index_ == 0 || index_ == 1)){
+    if (!tcp_img_req_ && cmd.send_rear_camera_image && (index_ == 0 || index_ == 1)){
       tcpImgReqThread_ = std::thread(&ScaleTruckController::requestImage, this, img_data_);
+      RTUtil::setThreadAttr(tcpImgReqThread_, imageCore_, rtEnable_ ? imagePrio_ : 0, "stc_img_req");
       tcp_img_req_ = true;
     }
 
-    if (!tcp_img_rep_ && req_lv_ && (index_ == 1 || index_ == 2)){
-      tcpImgRepThread_ = std::thread(&ScaleTruckController::replyImage, this);
-      tcp_img_rep_ = true;
-    }
-
     //recordData(laneDetector_.start_);
 
-    if(enableConsoleOutput_)
-      displayConsole();
-
-    gettimeofday(&end_time, NULL);
-    diff_time += ((end_time.tv_sec - start_time.tv_sec) * 1000.0) + ((end_time.tv_usec - start_time.tv_usec) / 1000.0);
-    cnt++;
-
-    CycleTime_ = diff_time / (double)cnt;
+    if(stats_)
+      updateStats();
 
-    printf("cnt: %d\n", cnt);
-    if (cnt > 3000){
-      diff_time = 0.0;
-      cnt = 0;
-    }
-
-    {
-      std::scoped_lock lock(rear_image_mutex_);
-      rearImageBackup_ = rearImageCopy_;
-    }
-    if(!rearImageBackup_.empty()){
-      imageCompress(rearImageBackup_, &compImageBackup_);
-      if(compImageBackup_.size() <= (sizeof(backup_data_->comp_image) / sizeof(uchar))){
-        std::copy(compImageBackup_.begin(), compImageBackup_.end(), backup_data_->comp_image);
-      }
-      backup_data_->size = compImageBackup_.size();
-    }
+    std::this_thread::sleep_until(next);
   }
 }
 
 void ScaleTruckController::ScanErrorCallback(const std_msgs::UInt32::ConstPtr &msg) {
   static bool gamma_flag = false;
   LdrErrMsg_ = msg->data;
-  if(fi_lidar_) {
+  if(commandState_.load().fi_lidar) {
     LdrErrMsg_ = 0x80008002;
   }
   if(LdrErrMsg_ && !gamma_flag){
-    std::scoped_lock lock(rep_mutex_, lane_mutex_);
-    gamma_ = true;
-    laneDetector_.gamma_ = true;
+    controlState_.update([](ControlState& state) { state.gamma = true; });
+  }
+}
+
+scale_truck_control::xav2lrc ScaleTruckController::xavMessage() {
+  const CommandState cmd = commandState_.load();
+  const ControlState ctrl = controlState_.load();
+  const LaneState lane = laneState_.load();
+  scale_truck_control::xav2lrc msg;
+
+  msg.tar_vel = emergencyBrake_ ? 0.0f : ctrl.result_vel;
+  msg.steer_angle = ctrl.angle_degree;
+  msg.cur_dist = ctrl.distance;
+  msg.rel_vel = ctrl.rel_vel;
+  msg.tar_dist = cmd.tar_dist;
+  msg.fi_encoder = cmd.fi_encoder;
+  msg.fi_camera = cmd.fi_camera;
+  msg.fi_lidar = cmd.fi_lidar;
+  msg.alpha = cmd.alpha;
+  msg.beta = ctrl.beta;
+  msg.gamma = ctrl.gamma;
+  msg.qos_level = qosLevel_;
+  msg.image_stamp = lane.image_stamp;
+  msg.scan_stamp = ctrl.scan_stamp;
+  msg.stc_stamp = ros::Time::now();
+  if(ctrl.tracked && !emergencyBrake_) {
+    // the lateral loop publishes between scans, carry the gap forward
+    double dt = std::min((msg.stc_stamp - ctrl.distance_stamp).toSec(), lidarPeriod_ / 1000.0);
+    if(dt > 0.0) msg.cur_dist += ctrl.rel_vel * dt;
   }
+  return msg;
 }
 
-void ScaleTruckController::objectCallback(const obstacle_detector::Obstacles &msg) {
+void ScaleTruckController::objectCallback(const obstacle_detector::Obstacles::ConstPtr &msg) {
+  if(!msg->header.stamp.isZero()) scanAge_.record((ros::Time::now() - msg->header.stamp).toSec() * 1000.0);
   {
     std::scoped_lock lock(object_mutex_);
     Obstacle_ = msg;
+    scanSeq_++;
   }
+  scan_cv_.notify_one();
+
+  /*************************/
+  /* Emergency Brake Check */
+  /*************************/
+  // runs per scan, the vision gated loop only refines the velocity
+  if(controlState_.load().gamma || commandState_.load().fi_lidar) {
+    emergencyBrake_ = false;
+    return;
+  }
+
+  float min_dist = 10.1f;
+  for(const auto& circle : msg->circles) {
+    float dist = -circle.center.x - circle.true_radius;
+    if(dist < min_dist) min_dist = dist;
+  }
+
+  const float stop_dist = (index_ == 0) ? LVstopDist_ : FVstopDist_;
+  if(min_dist > stop_dist) {
+    emergencyBrake_ = false;
+    return;
+  }
+
+  if(!emergencyBrake_.exchange(true)) brakeCnt_++;
+  controlState_.update([min_dist](ControlState& state) {
+    state.result_vel = 0.0f;
+    state.distance = min_dist;
+  });
+
+  scale_truck_control::xav2lrc xav = xavMessage();
+  xav.scan_stamp = msg->header.stamp;
+  XavPublisher_.publish(xav);
+
+  if(!msg->header.stamp.isZero()) {
+    double age = (ros::Time::now() - msg->header.stamp).toSec() * 1000.0;
+    brakeAge_.record(age);
+    if(age > lidarPeriod_) brakeLate_++;
+  }
+}
+
+/* Raw scan path, same handling as the obstacle_extractor output */
+void ScaleTruckController::scanCallback(const sensor_msgs::LaserScan::ConstPtr &msg) {
+  objectCallback(objectDetector_.detect(msg));
 }
 
 void ScaleTruckController::imageCallback(const sensor_msgs::ImageConstPtr &msg) {
-  cv_bridge::CvImagePtr cam_image;
+  cv_bridge::CvImageConstPtr cam_image;
   try{
-    cam_image = cv_bridge::toCvCopy(msg, sensor_msgs::image_encodings::BGR8);
+    // shares the message buffer when it is already bgr8
+    cam_image = cv_bridge::toCvShare(msg, sensor_msgs::image_encodings::BGR8);
   } catch (cv_bridge::Exception& e) {
     ROS_ERROR("cv_bridge exception : %s", e.what());
   }
+  if(!msg->header.stamp.isZero()) cameraAge_.record((ros::Time::now() - msg->header.stamp).toSec() * 1000.0);
 
+  const bool fi_camera = commandState_.load().fi_camera;
   {
-    std::scoped_lock lock(rep_mutex_, image_mutex_);
-    if(cam_image && !fi_camera_) {
+    std::scoped_lock lock(image_mutex_);
+    if(cam_image && !fi_camera) {
       imageHeader_ = msg->header;
-      camImageCopy_ = cam_image->image.clone();
       imageStatus_ = true;
+      imageSeq_++;
+
+      CameraFrame& frame = cameraFrames_.back();
+      frame.image = cam_image;
+      frame.seq = imageSeq_;
+      cameraFrames_.publish();
     }
   }
+  image_cv_.notify_all();
 }
 
 void ScaleTruckController::rearImageCallback(const sensor_msgs::ImageConstPtr &msg) {
-  cv_bridge::CvImagePtr cam_image;
+  cv_bridge::CvImageConstPtr cam_image;
   try{
-    cam_image = cv_bridge::toCvCopy(msg, sensor_msgs::image_encodings::BGR8);
+    cam_image = cv_bridge::toCvShare(msg, sensor_msgs::image_encodings::BGR8);
   } catch (cv_bridge::Exception& e) {
     ROS_ERROR("cv_bridge exception : %s", e.what());
   }
@@ -762,52 +1156,53 @@ void ScaleTruckController::rearImageCallback(const sensor_msgs::ImageConstPtr &m
   {
     std::scoped_lock lock(rear_image_mutex_);
     if(cam_image) {
-      rearImageCopy_ = cam_image->image.clone();
+      rearImage_ = cam_image;
+      rearSeq_++;
     }
   }
+  rear_cv_.notify_one();
 }
 
 void ScaleTruckController::XavSubCallback(const scale_truck_control::lrc2xav &msg){
-  {
-    std::scoped_lock lock(mode_mutex_);
-    //alpha_ = msg.alpha;
-    lrc_mode_ = msg.lrc_mode;
-    crc_mode_ = msg.crc_mode;
-  }
-  {
-    std::scoped_lock lock(vel_mutex_);
-    CurVel_ = msg.cur_vel;
-  }
-  if (index_ != 0) {  //FVs
-    std::scoped_lock lock(rep_mutex_);
-    if (lrc_mode_ == 0) {
-      TargetVel_ = msg.tar_vel;
-      TargetDist_ = msg.tar_dist;
+  if(!msg.lrc_stamp.isZero()) lrcAge_.record((ros::Time::now() - msg.lrc_stamp).toSec() * 1000.0);
+  commandState_.update([&](CommandState& cmd) {
+    //cmd.alpha = msg.alpha;
+    cmd.lrc_mode = msg.lrc_mode;
+    cmd.crc_mode = msg.crc_mode;
+    cmd.cur_vel = msg.cur_vel;
+    if (index_ == 0) {  //LV, crc_mode may have changed
+      applyCrcMode(cmd);
     }
-    else {
-      if (msg.tar_vel > RCMVel_)  TargetVel_ = RCMVel_;
-      else TargetVel_ = msg.tar_vel;
-      if (msg.tar_dist < RCMDist_)  TargetDist_ = RCMDist_; 
-      else TargetDist_ = msg.tar_dist;
+    else {  //FVs
+      if (cmd.lrc_mode == 0) {
+        cmd.tar_vel = msg.tar_vel;
+        cmd.tar_dist = msg.tar_dist;
+      }
+      else {
+        if (msg.tar_vel > RCMVel_)  cmd.tar_vel = RCMVel_;
+        else cmd.tar_vel = msg.tar_vel;
+        if (msg.tar_dist < RCMDist_)  cmd.tar_dist = RCMDist_; 
+        else cmd.tar_dist = msg.tar_dist;
+      }
     }
-  }
-  send_rear_camera_image_ = msg.send_rear_camera_image;
+    cmd.send_rear_camera_image = msg.send_rear_camera_image;
+  });
 }
 
 void ScaleTruckController::bboxCallback(const yolo_object_detection::bounding_box &msg){
-  {
-    std::scoped_lock lock(bbox_mutex_);
-    name_ = msg.name;
+  bboxState_.update([&](BboxState& bbox) {
+    strncpy(bbox.name, msg.name.c_str(), sizeof(bbox.name) - 1);
     if ((msg.x > 0 && msg.x < 640) && \
         (msg.y > 0 && msg.y < 480) && \
 	(msg.w > 0 && msg.w < 640) && \
 	(msg.h > 0 && msg.h < 480)){
-      x_ = msg.x;
-      y_ = msg.y;
-      w_ = msg.w;
-      h_ = msg.h;
+      bbox.x = msg.x;
+      bbox.y = msg.y;
+      bbox.w = msg.w;
+      bbox.h = msg.h;
+      bbox.seq++;
     }
-  }
+  });
 }
 
 void ScaleTruckController::clusterCallback(const sensor_msgs::PointCloud &msg) {
@@ -0,0 +1,73 @@
+#include "bbox_tracker/bbox_tracker.hpp"
+
+namespace BboxTracker {
+
+Tracker::Tracker(ros::NodeHandle nh)
+	: nodeHandle_(nh){
+	nodeHandle_.param("bbox_tracker/search_margin", search_margin_, 40);
+	nodeHandle_.param("bbox_tracker/min_confidence", min_confidence_, 0.6f);
+	nodeHandle_.param("bbox_tracker/redetect_frames", redetect_frames_, 15);
+	nodeHandle_.param("bbox_tracker/scale", scale_, 0.5);
+}
+
+void Tracker::reset(){
+	templ_.release();
+	confidence_ = 0.0f;
+	since_ = 0;
+	valid_ = false;
+}
+
+/* gray and scaled copy of roi only, the full frame is never converted */
+cv::Mat Tracker::prepare(const cv::Mat& frame, const cv::Rect& roi) const{
+	cv::Mat gray, out;
+	if (frame.channels() == 3) cv::cvtColor(frame(roi), gray, cv::COLOR_BGR2GRAY);
+	else gray = frame(roi);
+	if (scale_ == 1.0) return gray.clone();
+	cv::resize(gray, out, cv::Size(), scale_, scale_, cv::INTER_AREA);
+	return out;
+}
+
+void Tracker::init(const cv::Mat& frame, const cv::Rect& box){
+	reset();
+	box_ = box & cv::Rect(0, 0, frame.cols, frame.rows);
+	if (box_.width * scale_ < 4 || box_.height * scale_ < 4) return;
+
+	templ_ = prepare(frame, box_);
+	confidence_ = 1.0f;
+	valid_ = true;
+}
+
+bool Tracker::update(const cv::Mat& frame, cv::Rect* box){
+	since_++;
+	if (!valid_) return false;
+
+	const cv::Rect search = cv::Rect(box_.x - search_margin_, box_.y - search_margin_,
+		box_.width + 2 * search_margin_, box_.height + 2 * search_margin_) & cv::Rect(0, 0, frame.cols, frame.rows);
+	cv::Mat area = prepare(frame, search);
+	if (area.cols < templ_.cols || area.rows < templ_.rows) {
+		valid_ = false;
+		return false;
+	}
+
+	cv::Mat result;
+	double max_val;
+	cv::Point max_loc;
+	cv::matchTemplate(area, templ_, result, cv::TM_CCOEFF_NORMED);
+	cv::minMaxLoc(result, NULL, &max_val, NULL, &max_loc);
+	confidence_ = (float)max_val;
+	if (confidence_ < min_confidence_) {
+		valid_ = false;
+		return false;
+	}
+
+	box_.x = search.x + (int)(max_loc.x / scale_);
+	box_.y = search.y + (int)(max_loc.y / scale_);
+	*box = box_;
+	return true;
+}
+
+bool Tracker::needDetection() const{
+	return !valid_ || since_ >= redetect_frames_;
+}
+
+}
@@ -0,0 +1,115 @@
+#include "clock_sync/clock_sync.hpp"
+
+#include <math.h>
+
+namespace ClockSync {
+
+int64_t PeerClock::nowUs(){
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return toUs(now);
+}
+
+int64_t PeerClock::toUs(const struct timeval& tv){
+	return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+void PeerClock::reset(){
+	raw_count_ = raw_next_ = 0;
+	kept_count_ = kept_next_ = 0;
+	last_kept_ = 0;
+	off_fit_ = 0;
+	slow_ = 0;
+	fitted_ = false;
+}
+
+void PeerClock::addExchange(int64_t t1, int64_t t2, int64_t t3, int64_t t4){
+	ClockSample sample;
+	sample.local = t4;
+	sample.offset = ((t2 - t1) + (t3 - t4)) / 2.0;
+	sample.delay = fmax(0.0, (double)((t4 - t1) - (t3 - t2)));
+
+	raw_[raw_next_] = sample;
+	raw_next_ = (raw_next_ + 1) % CLOCK_FILTER;
+	if (raw_count_ < CLOCK_FILTER) raw_count_++;
+
+	// clock filter, each minimum is used once
+	const ClockSample* best = &raw_[0];
+	for (int i = 1; i < raw_count_; i++) {
+		if (raw_[i].delay < best->delay) best = &raw_[i];
+	}
+	if (best->local <= last_kept_) return;
+	last_kept_ = best->local;
+
+	// a busy receiver delays one way only, its offset is off by half the wait
+	if (fitted_ && best->delay > 2.0 * minDelay() + CLOCK_DELAY_SLACK) {
+		if (++slow_ < CLOCK_WINDOW) return;  // a slower path for good, take it
+	}
+	slow_ = 0;
+
+	if (fitted_ && fabs(best->offset - offsetUs(best->local)) > CLOCK_STEP) {
+		if (++off_fit_ < CLOCK_STEP_COUNT) return;  // outlier, unless it persists
+		ClockSample step = sample;
+		reset();  // peer restarted or its clock was set
+		raw_[0] = step;
+		raw_count_ = raw_next_ = 1;
+		last_kept_ = step.local;
+		best = &raw_[0];
+	}
+	off_fit_ = 0;
+
+	kept_[kept_next_] = *best;
+	kept_next_ = (kept_next_ + 1) % CLOCK_WINDOW;
+	if (kept_count_ < CLOCK_WINDOW) kept_count_++;
+	fit();
+}
+
+double PeerClock::minDelay() const{
+	double delay = kept_[0].delay;
+	for (int i = 1; i < kept_count_; i++) delay = fmin(delay, kept_[i].delay);
+	return delay;
+}
+
+/* Least squares line through the kept samples, offset only until they span CLOCK_SKEW_SPAN */
+void PeerClock::fit(){
+	const int64_t base = kept_[(kept_next_ + CLOCK_WINDOW - kept_count_) % CLOCK_WINDOW].local;
+	const ClockSample& newest = kept_[(kept_next_ + CLOCK_WINDOW - 1) % CLOCK_WINDOW];
+
+	double mt = 0.0, mo = 0.0;
+	for (int i = 0; i < kept_count_; i++) {
+		mt += kept_[i].local - base;
+		mo += kept_[i].offset;
+	}
+	mt /= kept_count_;
+	mo /= kept_count_;
+
+	double sxx = 0.0, sxy = 0.0;
+	for (int i = 0; i < kept_count_; i++) {
+		double dt = kept_[i].local - base - mt;
+		sxx += dt * dt;
+		sxy += dt * (kept_[i].offset - mo);
+	}
+
+	skew_ = 0.0;
+	if (kept_count_ >= 3 && newest.local - base >= CLOCK_SKEW_SPAN * 1e6 && sxx > 0.0) {
+		skew_ = fmax(-CLOCK_SKEW_MAX * 1e-6, fmin(CLOCK_SKEW_MAX * 1e-6, sxy / sxx));
+	}
+	ref_ = base + (int64_t)mt;
+	offset_ = mo;
+	delay_ = newest.delay;
+	fitted_ = true;
+}
+
+double PeerClock::offsetUs(int64_t local_us) const{
+	return offset_ + skew_ * (double)(local_us - ref_);
+}
+
+void PeerClock::toLocal(struct timeval* stamp) const{
+	if (!fitted_ || (stamp->tv_sec == 0 && stamp->tv_usec == 0)) return;
+	int64_t peer = toUs(*stamp);
+	int64_t local = peer - (int64_t)llround(offsetUs(peer - (int64_t)offset_));
+	stamp->tv_sec = local / 1000000;
+	stamp->tv_usec = local % 1000000;
+}
+
+}
@@ -0,0 +1,119 @@
+#include "dist_fusion/dist_fusion.hpp"
+
+namespace DistFusion {
+
+void MeasurementBuffer::push(const ros::Time& stamp, float dist){
+	if (count_ > 0) {
+		const Sample& newest = samples_[(head_ + FUSION_BUFFER - 1) % FUSION_BUFFER];
+		if (stamp < newest.stamp) return;  // out of order
+		if (stamp == newest.stamp) {
+			samples_[(head_ + FUSION_BUFFER - 1) % FUSION_BUFFER].dist = dist;
+			return;
+		}
+	}
+	samples_[head_].stamp = stamp;
+	samples_[head_].dist = dist;
+	head_ = (head_ + 1) % FUSION_BUFFER;
+	if (count_ < FUSION_BUFFER) count_++;
+}
+
+void MeasurementBuffer::clear(){
+	head_ = 0;
+	count_ = 0;
+}
+
+bool MeasurementBuffer::at(const ros::Time& t, double horizon, float* dist, double* age) const{
+	if (count_ == 0) return false;
+
+	const Sample& newest = samples_[(head_ + FUSION_BUFFER - 1) % FUSION_BUFFER];
+	if (t >= newest.stamp) {
+		*age = (t - newest.stamp).toSec();
+		*dist = newest.dist;
+		if (count_ >= 2) {
+			const Sample& prev = samples_[(head_ + FUSION_BUFFER - 2) % FUSION_BUFFER];
+			const double span = (newest.stamp - prev.stamp).toSec();
+			const double dt = std::min(*age, horizon);
+			if (span > 0.0) *dist += (newest.dist - prev.dist) / span * dt;
+		}
+		return true;
+	}
+
+	*age = 0.0;
+	for (int i = 1; i < count_; i++) {
+		const Sample& b = samples_[(head_ + FUSION_BUFFER - i) % FUSION_BUFFER];
+		const Sample& a = samples_[(head_ + FUSION_BUFFER - i - 1) % FUSION_BUFFER];
+		if (t >= a.stamp) {
+			const double r = (t - a.stamp).toSec() / (b.stamp - a.stamp).toSec();
+			*dist = a.dist + (b.dist - a.dist) * r;
+			return true;
+		}
+	}
+	*dist = samples_[(head_ + FUSION_BUFFER - count_) % FUSION_BUFFER].dist;  // before the oldest
+	return true;
+}
+
+DistanceFusion::DistanceFusion(ros::NodeHandle nh)
+	: nodeHandle_(nh){
+	nodeHandle_.param("fusion/lidar_sigma", sigma_[LIDAR], 0.02f);
+	nodeHandle_.param("fusion/camera_sigma", sigma_[CAMERA], 0.08f);
+	nodeHandle_.param("fusion/drift", drift_, 0.5f);
+	nodeHandle_.param("fusion/max_age", max_age_, 0.5);
+	nodeHandle_.param("fusion/horizon", horizon_, 0.2);
+	nodeHandle_.param("fusion/health_tau", health_tau_, 0.3);
+}
+
+void DistanceFusion::push(Sensor sensor, const ros::Time& stamp, float dist){
+	std::scoped_lock lock(mutex_);
+	buffer_[sensor].push(stamp, dist);
+}
+
+void DistanceFusion::setHealthy(Sensor sensor, bool healthy){
+	std::scoped_lock lock(mutex_);
+	healthy_[sensor] = healthy;
+}
+
+float DistanceFusion::health(Sensor sensor){
+	std::scoped_lock lock(mutex_);
+	return health_[sensor];
+}
+
+Result DistanceFusion::fuse(const ros::Time& t){
+	std::scoped_lock lock(mutex_);
+	Result res;
+
+	double dt = last_fuse_.isZero() ? 0.0 : (t - last_fuse_).toSec();
+	if (dt < 0.0) dt = 0.0;
+	last_fuse_ = t;
+	const float ramp = (health_tau_ > 0.0) ? (float)(1.0 - exp(-dt / health_tau_)) : 1.0f;
+
+	float sum_w = 0.0f, sum_wd = 0.0f;
+	float w[SENSORS] = {0.0f, 0.0f};
+	for (int s = 0; s < SENSORS; s++) {
+		health_[s] += ((healthy_[s] ? 1.0f : 0.0f) - health_[s]) * ramp;
+		if (!healthy_[s] && health_[s] < 0.01f) health_[s] = 0.0f;
+
+		float dist;
+		double age;
+		if (!buffer_[s].at(t, horizon_, &dist, &age)) continue;
+		res.age[s] = age;
+		if (age > max_age_) continue;
+
+		const float sigma = sigma_[s] + drift_ * (float)age;
+		w[s] = health_[s] / (sigma * sigma);
+		sum_w += w[s];
+		sum_wd += w[s] * dist;
+	}
+
+	if (sum_w > 1e-3f) {
+		res.dist = sum_wd / sum_w;
+		res.valid = true;
+		for (int s = 0; s < SENSORS; s++) res.weight[s] = w[s] / sum_w;
+		last_dist_ = res.dist;
+	}
+	else {
+		res.dist = last_dist_;
+	}
+	return res;
+}
+
+}
@@ -76,6 +76,16 @@ LaneDetector::LaneDetector(ros::NodeHandle nh)
 
   e_values_.resize(3);
 
+  /* lane point buffers keep their capacity across clear_release() */
+  left_x_.reserve(height_);
+  left_y_.reserve(height_);
+  right_x_.reserve(height_);
+  right_y_.reserve(height_);
+  center_x_.reserve(height_ * 2);
+  center_y_.reserve(height_ * 2);
+  left_lane_.reserve(height_);
+  right_lane_.reserve(height_);
+
   float t_gap[2], b_gap[2], t_height[2], b_height[2], f_extra[2], b_extra[2];
   int top_gap[2], bot_gap[2], top_height[2], bot_height[2], extra_up[2], extra_down[2];
 
@@ -212,7 +222,7 @@ int LaneDetector::arrMaxIdx(int hist[], int start, int end, int Max) {
   return max_index;
 }
 
-Mat LaneDetector::polyfit(vector<int> x_val, vector<int> y_val) {
+Mat LaneDetector::polyfit(const vector<int>& x_val, const vector<int>& y_val) {
   Mat coef(3, 1, CV_32F);
   int i, j, k, n, N;
   N = (int)x_val.size();
@@ -512,46 +522,227 @@ Mat LaneDetector::detect_lines_sliding_window(Mat _frame, bool _view) {
     R_prev = Rlane_current;
   }
 
-  float left_lane_value[480] = { 0,};
-  float right_lane_value[480] = { 0,};
-  float center_lane_value[480] = { 0,};
+  fit_lanes(480);
+
+  delete[] hist;
+
+  return result;
+}
 
-  if (left_x_.size() != 0) {
+void LaneDetector::fit_lanes(int rows) {
+  bool left_found = (left_x_.size() != 0);
+  bool right_found = (right_x_.size() != 0);
+
+  if (left_found) {
     left_coef_ = polyfit(left_y_, left_x_);
-    for(int i = 0; i < 480; i++){
-      left_lane_value[i] = left_coef_.at<float>(2,0) * pow(i,2) + left_coef_.at<float>(1,0) * i + left_coef_.at<float>(0,0);
-    }
   }
-  if (right_x_.size() != 0) {
+  if (right_found) {
     right_coef_ = polyfit(right_y_, right_x_);
-    for(int i = 0; i < 480; i++){
-      right_lane_value[i] = right_coef_.at<float>(2,0) * pow(i,2) + right_coef_.at<float>(1,0) * i + right_coef_.at<float>(0,0);
-    }
   }
-  
-  for (int i = 0; i < 480; i++){
-    float center_x_value = (left_lane_value[i] + right_lane_value[i]) / 2;
+
+  const float la = left_coef_.at<float>(2,0), lb = left_coef_.at<float>(1,0), lc = left_coef_.at<float>(0,0);
+  const float ra = right_coef_.at<float>(2,0), rb = right_coef_.at<float>(1,0), rc = right_coef_.at<float>(0,0);
+
+  for (int i = 0; i < rows; i++){
+    float left_lane_value = left_found ? (la * i * i + lb * i + lc) : 0.0f;
+    float right_lane_value = right_found ? (ra * i * i + rb * i + rc) : 0.0f;
+
     center_y_.push_back(i);
-    center_x_.push_back(center_x_value);
+    center_x_.push_back((left_lane_value + right_lane_value) / 2);
+    left_lane_.push_back(Point(left_lane_value, i));
+    right_lane_.push_back(Point(right_lane_value, i));
   }
-  
+
   if (center_x_.size() != 0){
     center_coef_ = polyfit(center_y_, center_x_);
   }
+}
 
-  for(int i = 0; i < 480; i++){
-    Point left_tmp(left_lane_value[i], i);
-    Point right_tmp(right_lane_value[i], i);
-    left_lane_.push_back(left_tmp);
-    right_lane_.push_back(right_tmp);
+/* Same search as detect_lines_sliding_window, specialized for W x H.
+ * Windows are summed straight from the binary rows instead of rescanning
+ * the findNonZero list, the frame is padded by one window on each side so
+ * the per-window loops have a constant trip count, and all scratch memory
+ * is sized at compile time. */
+template <int W, int H>
+Mat LaneDetector::detect_lines_sliding_window_fixed(const Mat& _frame, bool _view) {
+  typedef LaneGeometry<W, H> Geo;
+  constexpr int mid_point = W / 2;
+  constexpr int n_windows = Geo::n_windows;
+  constexpr int margin = Geo::margin;
+  constexpr int min_pix = Geo::min_pix;
+  constexpr int window_width = Geo::window_width;
+  constexpr int pad = window_width;
+  constexpr int stride = W + 2 * pad;
+  constexpr int edge = 100 * W / CameraGeometry::width;  // lane bases are not searched this close to the border
+  const int scale = width_ / W;  // > 1 when QoS runs the search at reduced resolution
+
+  static uchar frame[H][stride];  // zero padded copy of _frame
+  static int hist[W];
+  static int Llane_x[H + 1], Rlane_x[H + 1];  // per row mean x of the current window, -1 if empty
+
+  Mat result;
+
+  for (int j = 0; j < H; j++) {
+    memcpy(&frame[j][pad], _frame.ptr<uchar>(j), W);
   }
 
-  delete[] hist;
+  const bool track_only = (qos_level_ >= QOS_TRACK_ONLY) && (last_Llane_base_ != 0) && (last_Rlane_base_ != 0);
+  if (!track_only) {
+    memset(hist, 0, sizeof(hist));
+    for (int j = (H / 2); j < H; j++) {
+      const uchar* row = &frame[j][pad];
+      for (int i = 0; i < W; i++) {
+        hist[i] += (row[i] == 255);
+      }
+    }
+  }
+
+  if (_view) {
+    cvtColor(_frame, sliding_result_, COLOR_GRAY2BGR);
+    result = sliding_result_;
+  }
+
+  int window_height;
+  int distance;
+  if (option_) {
+    distance = distance_ / scale;
+    window_height = (H >= distance) ? ((H - distance) / n_windows) : (H / n_windows);
+  } else {
+    distance = 0;
+    window_height = H / n_windows;
+  }
+
+  int Llane_base, Rlane_base;
+  if (track_only) {
+    Llane_base = last_Llane_base_ / scale;
+    Rlane_base = last_Rlane_base_ / scale;
+  }
+  else {
+    Llane_base = arrMaxIdx(hist, edge, mid_point, W);
+    Rlane_base = arrMaxIdx(hist, mid_point, W - edge, W);
+  }
+  if (Llane_base == -1 || Rlane_base == -1)
+    return result;
+
+  int Llane_current = Llane_base;
+  int Rlane_current = Rlane_base;
+  int L_prev = Llane_current;
+  int R_prev = Rlane_current;
+  int L_gap = 0;
+  int R_gap = 0;
+
+  for (int window = 0; window < n_windows; window++) {
+    const int y_pos = H - (window + 1) * window_height - 1;
+    const int y_top = H - window * window_height;
+    const int rows = y_top - y_pos;
+
+    // windows fully outside the frame only ever see padding
+    const int Lx_pos = std::min(std::max(Llane_current - margin, -pad), W);
+    const int Rx_pos = std::min(std::max(Rlane_current - margin, -pad), W);
+
+    if (_view) {
+      rectangle(result, Rect(Lx_pos, y_pos, window_width, window_height), Scalar(255, 50, 100), 1);
+      rectangle(result, Rect(Rx_pos, y_pos, window_width, window_height), Scalar(100, 50, 255), 1);
+    }
+
+    int Lsum = 0, Rsum = 0;
+    int Lcount = 0, Rcount = 0;
+
+    for (int r = 0; r < rows; r++) {
+      const int i = y_top - 1 - r;
+      Llane_x[r] = Rlane_x[r] = -1;
+      if (i < 0 || i <= distance) continue;
+
+      const uchar* Lrow = &frame[i][pad + Lx_pos];
+      const uchar* Rrow = &frame[i][pad + Rx_pos];
+      int Ly_sum = 0, Ry_sum = 0;
+      int Ly_count = 0, Ry_count = 0;
+      for (int k = 0; k < window_width; k++) {
+        const int Lon = (Lrow[k] != 0);
+        const int Ron = (Rrow[k] != 0);
+        Ly_sum += Lon * (Lx_pos + k);
+        Ly_count += Lon;
+        Ry_sum += Ron * (Rx_pos + k);
+        Ry_count += Ron;
+      }
+      if (Ly_count != 0) Llane_x[r] = Ly_sum / Ly_count;
+      if (Ry_count != 0) Rlane_x[r] = Ry_sum / Ry_count;
+      Lsum += Ly_sum;
+      Lcount += Ly_count;
+      Rsum += Ry_sum;
+      Rcount += Ry_count;
+
+      if (_view) {
+        Vec3b* out = result.ptr<Vec3b>(i);
+        for (int k = 0; k < window_width; k++) {
+          if (Lrow[k] != 0) out[Lx_pos + k] = Vec3b(255, 0, 0);
+          if (Rrow[k] != 0) out[Rx_pos + k] = Vec3b(0, 0, 255);
+        }
+      }
+    }
+
+    if (Lcount > min_pix) {
+      for (int r = 0; r < rows; r++) {
+        if (Llane_x[r] != -1) {
+          left_x_.push_back(Llane_x[r]);
+          left_y_.push_back(y_top - 1 - r);
+        }
+      }
+      Llane_current = Lsum / Lcount;
+    } else {
+      Lsum = 0;
+      Llane_current += L_gap;
+    }
+    if (Rcount > min_pix) {
+      for (int r = 0; r < rows; r++) {
+        if (Rlane_x[r] != -1) {
+          right_x_.push_back(Rlane_x[r]);
+          right_y_.push_back(y_top - 1 - r);
+        }
+      }
+      Rlane_current = Rsum / Rcount;
+    } else {
+      Rsum = 0;
+      Rlane_current += R_gap;
+    }
+    if (window != 0) {
+      if (Rlane_current != R_prev) {
+        R_gap = (Rlane_current - R_prev);
+      }
+      if (Llane_current != L_prev) {
+        L_gap = (Llane_current - L_prev);
+      }
+    }
+    if ((Lsum != 0) && (Rsum != 0)) {
+      for (int r = 0; r < rows; r++) {
+        if ((Llane_x[r] != -1) && (Rlane_x[r] != -1)) {
+          center_x_.push_back((Llane_x[r] + Rlane_x[r]) / 2);
+          center_y_.push_back(y_top - 1 - r);
+        }
+      }
+    }
+    if (window == 0) {
+      last_Llane_base_ = Llane_current * scale;
+      last_Rlane_base_ = Rlane_current * scale;
+    }
+    L_prev = Llane_current;
+    R_prev = Rlane_current;
+  }
+
+  /* fit in full resolution pixels so the coefficients do not depend on the level */
+  if (scale > 1) {
+    for (auto& v : left_x_) v *= scale;
+    for (auto& v : left_y_) v *= scale;
+    for (auto& v : right_x_) v *= scale;
+    for (auto& v : right_y_) v *= scale;
+    for (auto& v : center_x_) v *= scale;
+    for (auto& v : center_y_) v *= scale;
+  }
+  fit_lanes(H * scale);
 
   return result;
 }
 
-
 float LaneDetector::lowPassFilter(double sampling_time, float est_value, float prev_res){
   float res = 0;
   float tau = 0.10f;
@@ -851,11 +1042,17 @@ Mat LaneDetector::estimateDistance(Mat frame, Mat trans, double cycle_time, bool
   if (name_ == "tail"){
     //est_dist = 1.24f - (dist_pixel/490.0f);
     est_dist = 1.2f - (dist_pixel/500.0f); //front-facing camera
-    if (est_dist > 0.26f && est_dist < 1.24f) est_dist_ = est_dist;
+    if (est_dist > 0.26f && est_dist < 1.24f) {
+      est_dist_ = est_dist;
+      est_seq_++;
+    }
   }
   else{
     est_dist = 1.35f - (dist_pixel/480.0f); //rear camera
-    if (est_dist > 0.26f && est_dist < 1.35f) est_dist_ = est_dist;
+    if (est_dist > 0.26f && est_dist < 1.35f) {
+      est_dist_ = est_dist;
+      est_seq_++;
+    }
   }
 
   return res_frame;
@@ -997,6 +1194,9 @@ float LaneDetector::display_img(Mat _frame, int _delay, bool _view) {
   static struct timeval startTime, endTime;
   static bool flag = false;
   double diffTime = 0.0;
+  const bool view = _view && (qos_level_ < QOS_NO_DRAW);
+  const bool fixed_size = (width_ == CameraGeometry::width && height_ == CameraGeometry::height);
+  qos_frame_++;
 
   if (beta_){
     map1_ = r_map1_.clone();
@@ -1046,9 +1246,19 @@ float LaneDetector::display_img(Mat _frame, int _delay, bool _view) {
   filters->apply(gpu_warped_frame, gpu_blur_frame);
   cuda::cvtColor(gpu_blur_frame, gpu_gray_frame, COLOR_BGR2GRAY);
   gpu_gray_frame.download(gray_frame);
-  adaptiveThreshold(gray_frame, binary_frame, 255, ADAPTIVE_THRESH_MEAN_C, THRESH_BINARY, 51, -50);
 
-  sliding_frame = detect_lines_sliding_window(binary_frame, _view);
+  if (fixed_size && qos_level_ >= QOS_HALF_RES) {
+    resize(gray_frame, gray_frame, Size(width_ / 2, height_ / 2), 0, 0, INTER_AREA);
+    adaptiveThreshold(gray_frame, binary_frame, 255, ADAPTIVE_THRESH_MEAN_C, THRESH_BINARY, 25, -50);
+    sliding_frame = detect_lines_sliding_window_fixed<CameraGeometry::width / 2, CameraGeometry::height / 2>(binary_frame, view);
+  }
+  else {
+    adaptiveThreshold(gray_frame, binary_frame, 255, ADAPTIVE_THRESH_MEAN_C, THRESH_BINARY, 51, -50);
+    if (fixed_size)
+      sliding_frame = detect_lines_sliding_window_fixed<CameraGeometry::width, CameraGeometry::height>(binary_frame, view);
+    else
+      sliding_frame = detect_lines_sliding_window(binary_frame, view);
+  }
 
   //estimate Distance
   if (gamma_ && (x_!=0 && y_!=0 && w_!=0 && h_!=0)){
@@ -1061,15 +1271,17 @@ float LaneDetector::display_img(Mat _frame, int _delay, bool _view) {
       diffTime = (endTime.tv_sec - startTime.tv_sec) + (endTime.tv_usec - startTime.tv_usec)/1000000.0;
       startTime = endTime;
     }
-    sliding_frame = estimateDistance(sliding_frame, trans, diffTime, _view);
-    if (beta_ && name_ == "head"){
-      crop_frame = estimatePose(binary_frame, diffTime, _view);
+    sliding_frame = estimateDistance(sliding_frame, trans, diffTime, view);
+    // pose needs the full resolution binary, otherwise the last est_pose_ is kept
+    const bool pose_frame = (qos_level_ < QOS_REDUCED_RATE) || ((qos_frame_ & 1) && binary_frame.cols == width_);
+    if (beta_ && name_ == "head" && pose_frame){
+      crop_frame = estimatePose(binary_frame, diffTime, view);
     }
   }
 
   controlSteer();
 
-  if (_view) {
+  if (view) {
     resized_frame = draw_lane(sliding_frame, new_frame);
     
     namedWindow("Window1");
@@ -0,0 +1,82 @@
+#include "latency/latency.hpp"
+
+namespace Latency {
+
+/* bin upper bounds, the last bin takes everything above 500 ms */
+const double LatencyHistogram::bounds_[LATENCY_BINS - 1] = {1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0, 200.0, 500.0};
+
+LatencyHistogram::LatencyHistogram(const std::string& name)
+	: name_(name){
+}
+
+double LatencyHistogram::ageMs(const struct timeval& stamp){
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return ((now.tv_sec - stamp.tv_sec) * 1000.0) + ((now.tv_usec - stamp.tv_usec) / 1000.0);
+}
+
+void LatencyHistogram::record(const struct timeval& stamp){
+	if (stamp.tv_sec == 0 && stamp.tv_usec == 0) return;  // source not stamped yet
+	record(ageMs(stamp));
+}
+
+void LatencyHistogram::record(double age_ms){
+	if (age_ms < 0.0) age_ms = 0.0;  // clock skew between hosts
+
+	int bin = 0;
+	while (bin < LATENCY_BINS - 1 && age_ms > bounds_[bin]) bin++;
+
+	std::scoped_lock lock(mutex_);
+	if (count_ > 3000) {
+		for (int i = 0; i < LATENCY_BINS; i++) bins_[i] = 0;
+		count_ = 0;
+		sum_ = 0.0;
+		max_ = 0.0;
+	}
+	bins_[bin]++;
+	count_++;
+	sum_ += age_ms;
+	if (age_ms > max_) max_ = age_ms;
+}
+
+void LatencyHistogram::reset(){
+	std::scoped_lock lock(mutex_);
+	for (int i = 0; i < LATENCY_BINS; i++) bins_[i] = 0;
+	count_ = 0;
+	sum_ = 0.0;
+	max_ = 0.0;
+}
+
+double LatencyHistogram::mean(){
+	std::scoped_lock lock(mutex_);
+	return count_ ? sum_ / (double)count_ : 0.0;
+}
+
+double LatencyHistogram::max(){
+	std::scoped_lock lock(mutex_);
+	return max_;
+}
+
+double LatencyHistogram::percentile(double p){
+	std::scoped_lock lock(mutex_);
+	if (count_ == 0) return 0.0;
+
+	uint32_t target = (uint32_t)(p * count_);
+	uint32_t acc = 0;
+	for (int i = 0; i < LATENCY_BINS - 1; i++) {
+		acc += bins_[i];
+		if (acc > target) return bounds_[i];
+	}
+	return max_;
+}
+
+std::string LatencyHistogram::summary(){
+	char buf[128];
+	double avg = mean();
+	double p99 = percentile(0.99);
+	std::scoped_lock lock(mutex_);
+	snprintf(buf, sizeof(buf), "%-16s: %7.2f avg / %7.2f p99 / %7.2f max ms (%u)", name_.c_str(), avg, p99, max_, count_);
+	return std::string(buf);
+}
+
+}
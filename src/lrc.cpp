@@ -14,7 +14,8 @@ LocalRC::LocalRC(ros::NodeHandle nh)
 
 LocalRC::~LocalRC(){
   is_node_running_ = false; 
-  udpThread_.join();
+  ZMQ_SOCKET_.controlDone_ = true;
+  if (zmqThread_.joinable()) zmqThread_.join();
 
   delete lrc_data_;
 }
@@ -41,6 +42,17 @@ void LocalRC::init(){
   nodeHandle_.param("LrcParams/rcm_dist", rcm_dist_, 0.8f);
   nodeHandle_.param("LrcParams/enable_console_output", EnableConsoleOutput_, true);
 
+  /******************/
+  /* RT Mode Option */
+  /******************/
+  nodeHandle_.param("LrcParams/rt/enable", rt_enable_, false);
+  nodeHandle_.param("LrcParams/rt/lock_memory", rt_lock_memory_, true);
+  nodeHandle_.param("LrcParams/rt/cycle_budget_ms", cycle_budget_, 5.0);
+  nodeHandle_.param("LrcParams/rt/lrc_core", lrc_core_, -1);  // -1 = not pinned
+  nodeHandle_.param("LrcParams/rt/zmq_core", zmq_core_, -1);
+  nodeHandle_.param("LrcParams/rt/lrc_prio", lrc_prio_, 80);  // SCHED_FIFO
+  nodeHandle_.param("LrcParams/rt/zmq_prio", zmq_prio_, 70);
+
   /******************************/
   /* ROS Topic Subscribe Option */
   /******************************/
@@ -75,14 +87,18 @@ void LocalRC::init(){
   lrc_data_->src_index = index_;
   lrc_data_->tar_index = 30;  //CRC
 
-  lrcThread_ = std::thread(&LocalRC::communicate, this);
-  tcpThread_ = std::thread(&LocalRC::request, this, lrc_data_);
-  if (index_ == 10){
-    udpThread_ = std::thread(&LocalRC::radio, this, lrc_data_);
+  cycleMonitor_.setBudget(cycle_budget_);
+  if (rt_enable_ && rt_lock_memory_){
+    RTUtil::lockMemory(256 * 1024);
   }
-  else if (index_ == 11 || index_ == 12){
-    udpThread_ = std::thread(&LocalRC::dish, this);
+  if (EnableConsoleOutput_){
+    stats_.reset(new StatsShm::StatsWriter("lrc" + std::to_string(index_)));
   }
+
+  lrcThread_ = std::thread(&LocalRC::communicate, this);
+  zmqThread_ = std::thread(&LocalRC::communicateZMQ, this, lrc_data_);
+  RTUtil::setThreadAttr(lrcThread_, lrc_core_, rt_enable_ ? lrc_prio_ : 0, "lrc_main");
+  RTUtil::setThreadAttr(zmqThread_, zmq_core_, rt_enable_ ? zmq_prio_ : 0, "lrc_zmq");
 }
 
 bool LocalRC::isNodeRunning(){
@@ -117,6 +133,7 @@ void LocalRC::XavCallback(const scale_truck_control::xav2lrc &msg){
   std::scoped_lock lock(data_mutex_);
   angle_degree_ = msg.steer_angle;
   cur_dist_ = msg.cur_dist;
+  rel_vel_ = msg.rel_vel;
   if(index_ == 10){  //only LV LRC
     tar_dist_ = msg.tar_dist;
     tar_vel_ = msg.tar_vel;
@@ -127,6 +144,11 @@ void LocalRC::XavCallback(const scale_truck_control::xav2lrc &msg){
   alpha_ = msg.alpha;
   beta_ = msg.beta;
   gamma_ = msg.gamma;
+  qos_level_ = msg.qos_level;
+  image_stamp_ = msg.image_stamp;
+  scan_stamp_ = msg.scan_stamp;
+  stc_stamp_ = msg.stc_stamp;
+  if(!msg.stc_stamp.isZero()) stcAge_.record((ros::Time::now() - msg.stc_stamp).toSec() * 1000.0);
 }
 
 void LocalRC::OcrCallback(const scale_truck_control::ocr2lrc &msg){
@@ -157,6 +179,14 @@ void LocalRC::OcrCallback(const scale_truck_control::ocr2lrc &msg){
   ref_vel_ = msg.ref_vel;
   cur_vel_ = msg.cur_vel;
   sat_vel_ = msg.u_k;  //saturated velocity
+
+  /* OpenCR echoes the stamps of the command it is running on */
+  if(!msg.cmd_stamp.isZero()){
+    ros::Time now = ros::Time::now();
+    double rtt = (now - msg.cmd_stamp).toSec() * 1000.0;
+    ocrRtt_.record(rtt);
+    if(!msg.image_stamp.isZero()) glassToWheel_.record((now - msg.image_stamp).toSec() * 1000.0 - rtt / 2.0);
+  }
 }
 
 void LocalRC::rosPub(){
@@ -180,52 +210,64 @@ void LocalRC::rosPub(){
     ocr.preceding_truck_vel = preceding_truck_vel_;
     ocr.fi_encoder = fi_encoder_;
     ocr.alpha = alpha_;
+    ocr.image_stamp = image_stamp_;
+    ocr.stc_stamp = stc_stamp_;
   }
+  xav.lrc_stamp = ros::Time::now();
+  ocr.lrc_stamp = xav.lrc_stamp;
   XavPublisher_.publish(xav);
   OcrPublisher_.publish(ocr);
 }
 
-void LocalRC::radio(ZmqData* zmq_data)
+/* ZMQ reactor thread: beacon to / from the platoon, telemetry to the CRC */
+void LocalRC::communicateZMQ(ZmqData* zmq_data)
 {
-  while(isNodeRunning()){
+  ZMQ_SOCKET_.onRequest(zmq_data,
+    [this](ZmqData* data) {
+      std::scoped_lock lock(data_mutex_);
+      data->tar_vel = tar_vel_;
+      data->ref_vel = ref_vel_;
+      data->cur_vel = cur_vel_;
+      data->tar_dist = tar_dist_;
+      data->cur_dist = cur_dist_;
+      data->alpha = alpha_;
+      data->beta = beta_;
+      data->gamma = gamma_;
+      data->lrc_mode = lrc_mode_;
+      data->qos_level = qos_level_;
+      data->image_stamp.tv_sec = image_stamp_.sec;
+      data->image_stamp.tv_usec = image_stamp_.nsec / 1000;
+    },
+    [this](ZmqData* data) { updateData(data); });
+
+  if (index_ == 10){  //LV, beacon only carries the platoon target so it stays quiet while that holds
+    beacon_data_.src_index = index_;
+    ZMQ_SOCKET_.onRadio(&beacon_data_,
+      [this](ZmqData* data) {
+        std::scoped_lock lock(data_mutex_);
+        data->tar_vel = tar_vel_;
+        data->tar_dist = tar_dist_;
+      });
+  }
+  else if (index_ == 11 || index_ == 12){  //FVs, RCM until the LV is heard
     {
       std::scoped_lock lock(data_mutex_);
-      zmq_data->tar_vel = tar_vel_;
-      zmq_data->tar_dist = tar_dist_;
+      leader_stale_ = true;
     }
-    ZMQ_SOCKET_.radioZMQ(zmq_data);
-    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    ZMQ_SOCKET_.onDish([this](ZmqData* data) { updateData(data); },
+      [this](bool stale) { leaderStale(stale); });
   }
-}
 
-void LocalRC::dish()
-{
-  while(isNodeRunning()){
-    ZMQ_SOCKET_.dishZMQ();
-    updateData(ZMQ_SOCKET_.dsh_recv_);
-    std::this_thread::sleep_for(std::chrono::milliseconds(2));
-  }
+  ZMQ_SOCKET_.spin();
 }
 
-void LocalRC::request(ZmqData* zmq_data){
-  struct timeval startTime, endTime;
-  double diff_time = 0.0;
-  while(isNodeRunning()){
-    {
-      std::scoped_lock lock(data_mutex_);
-      zmq_data->tar_vel = tar_vel_;
-      zmq_data->ref_vel = ref_vel_;
-      zmq_data->cur_vel = cur_vel_;
-      zmq_data->tar_dist = tar_dist_;
-      zmq_data->cur_dist = cur_dist_;
-      zmq_data->alpha = alpha_;
-      zmq_data->beta = beta_;
-      zmq_data->gamma = gamma_;
-      zmq_data->lrc_mode = lrc_mode_;
-    }
-    ZMQ_SOCKET_.requestZMQ(zmq_data);
-    updateData(ZMQ_SOCKET_.req_recv_);
-    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+/* LV beacons timed out: hold the RCM limits until they are back */
+void LocalRC::leaderStale(bool stale){
+  std::scoped_lock lock(data_mutex_);
+  leader_stale_ = stale;
+  if(stale){
+    if(tar_vel_ > rcm_vel_) tar_vel_ = rcm_vel_;
+    if(tar_dist_ < rcm_dist_) tar_dist_ = rcm_dist_;
   }
 }
 
@@ -268,10 +310,14 @@ void LocalRC::updateMode(uint8_t crc_mode){
     else{
       lrc_mode_ = 0;
     }
+    if(leader_stale_ && lrc_mode_ == 0){
+      lrc_mode_ = 1;  //RCM, no target from the LV
+    }
   }
 }
 
 void LocalRC::updateData(ZmqData* zmq_data){
+  if(zmq_data->clock_synced) zmqAge_.record(zmq_data->send_stamp);  //beacons carry no exchange, never synced
   std::scoped_lock lock(data_mutex_);
   if(zmq_data->src_index == 30){  //from CRC
     est_vel_ = zmq_data->est_vel;
@@ -329,22 +375,38 @@ void LocalRC::recordData(struct timeval *startTime){
   write_file.close();
 }
 
-void LocalRC::printStatus(){
-  static int cnt = 0;
-  static int CNT = 0;
-  if (EnableConsoleOutput_){
-    printf("\033[2J");
-    printf("\033[1;1H");
-    printf("\nPredict Velocity:\t%.3f", est_vel_);
-    printf("\nTarget Velocity:\t%.3f", tar_vel_);
-    printf("\nCurrent Velocity:\t%.3f", cur_vel_);
-    printf("\nTarget Distance:\t%.3f", tar_dist_);
-    printf("\nCurrent Distance:\t%.3f", cur_dist_);
-    printf("\nEstimated Value:\t%.3f", fabs(cur_vel_ - hat_vel_));
-    printf("\nalpha, beta, gamma:\t%d, %d, %d", alpha_, beta_, gamma_); 
-    printf("\nMODE:\t%d", lrc_mode_);
-    printf("\n");
+/* Status page for stc_top, refreshed every 10th cycle (~50 ms) */
+void LocalRC::updateStats(){
+  if (!stats_ || ++stats_cnt_ < 10) return;
+  stats_cnt_ = 0;
+
+  char title[64];
+  snprintf(title, sizeof(title), "LRC %d", index_);
+  stats_->begin(title);
+  stats_->printf("Predict Velocity:\t%.3f", est_vel_);
+  stats_->printf("Target Velocity:\t%.3f", tar_vel_);
+  stats_->printf("Current Velocity:\t%.3f", cur_vel_);
+  stats_->printf("Target Distance:\t%.3f", tar_dist_);
+  stats_->printf("Current Distance:\t%.3f (%.3f m/s)", cur_dist_, rel_vel_);
+  stats_->printf("Estimated Value:\t%.3f", fabs(cur_vel_ - hat_vel_));
+  stats_->printf("alpha, beta, gamma:\t%d, %d, %d", alpha_, beta_, gamma_); 
+  stats_->printf("MODE:\t%d", lrc_mode_);
+  stats_->printf("QoS Level:\t%d", qos_level_);
+  stats_->printf("Wire Errors:\t%u", ZMQ_SOCKET_.wire_errors_.load());
+  for(const std::string& line : ZMQ_SOCKET_.healthReport()) stats_->printf("%s", line.c_str());
+  const BeaconStats& beacon = ZMQ_SOCKET_.beacon_stats_;
+  if(index_ == 10){
+    stats_->printf("Beacon:\t%u sent, %u suppressed", beacon.sent.load(), beacon.suppressed.load());
+  }
+  else{
+    stats_->printf("Beacon:\t%u rx, %.1f%% lost, %u late, age %.1f ms, %u timeouts%s", beacon.received.load(), beacon.lossRate() * 100.0f, beacon.late.load(), beacon.ageMs(), beacon.timeouts.load(), leader_stale_ ? " (STALE)" : "");
   }
+  stats_->printf("%s", stcAge_.summary().c_str());
+  stats_->printf("%s", ocrRtt_.summary().c_str());
+  stats_->printf("%s", glassToWheel_.summary().c_str());
+  stats_->printf("%s", zmqAge_.summary().c_str());
+  stats_->printf("%s", cycleMonitor_.summary().c_str());
+  stats_->commit();
 }
 
 void LocalRC::communicate(){
@@ -352,10 +414,12 @@ void LocalRC::communicate(){
   gettimeofday(&startTime, NULL);
   static int cnt = 0;
   while(ros::ok()){
+    cycleMonitor_.begin();
     //encoderCheck();
     updateMode(crc_mode_);
     rosPub();
-    printStatus();
+    cycleMonitor_.end();
+    updateStats();
 
     //recordData(&startTime);
 
@@ -2,21 +2,147 @@
 
 namespace object_detect {
 
-ObjectDetector::ObjectDetector(ros::NodeHandle nh){
-
+ObjectDetector::ObjectDetector(ros::NodeHandle nh)
+  : nodeHandle_(nh) {
+  LoadParams();
 }
 
 ObjectDetector::~ObjectDetector(void){
 
 }
 
-ObjectDetector::scanCallback(const sensor_msgs::LaserScan::ConstPtr& scan) {
-  int cnt = scan->scan_time / scan->/time_increment;
-  
-  for(int i = 0; i < cnt; i++) {
-    float degree = RAD2DEG(scan->angle_min + scan->angle_increment * i);
-    
+void ObjectDetector::LoadParams(void){
+  nodeHandle_.param("object_detect/fov", fov_, 1.05f);  // laser_filter kept |angle| > 2.62
+  nodeHandle_.param("object_detect/min_range", min_range_, 0.15f);
+  nodeHandle_.param("object_detect/max_range", max_range_, 3.0f);
+  nodeHandle_.param("object_detect/cluster_gap", cluster_gap_, 0.1f);
+  nodeHandle_.param("object_detect/cluster_proportion", cluster_proportion_, 0.00628f);
+  nodeHandle_.param("object_detect/min_points", min_points_, 5);
+  nodeHandle_.param("object_detect/depth_tolerance", depth_tolerance_, 0.08f);
+}
+
+/* Forward is -x, so the sector wraps around +-pi. Its indices run from the
+ * end of the scan into the start, cos/sin are cached per index */
+void ObjectDetector::updateSector(const sensor_msgs::LaserScan& scan){
+  if (scan.ranges.size() == scan_size_ && scan.angle_min == angle_min_ && scan.angle_increment == angle_increment_) return;
+
+  scan_size_ = scan.ranges.size();
+  angle_min_ = scan.angle_min;
+  angle_increment_ = scan.angle_increment;
+  index_.clear();
+  cos_.clear();
+  sin_.clear();
+
+  const float half = fov_ / 2.0f;
+  std::vector<int> upper, lower;
+  for (size_t i = 0; i < scan_size_; i++) {
+    float angle = std::remainder(angle_min_ + angle_increment_ * i, 2.0f * (float)M_PI);
+    if (angle >= (float)M_PI - half) upper.push_back(i);
+    else if (angle <= -(float)M_PI + half) lower.push_back(i);
+  }
+  if (angle_increment_ < 0.0f) std::swap(upper, lower);
+  index_ = upper;
+  index_.insert(index_.end(), lower.begin(), lower.end());
+
+  for (int i : index_) {
+    const float angle = angle_min_ + angle_increment_ * i;
+    cos_.push_back(cosf(angle));
+    sin_.push_back(sinf(angle));
+  }
+  range_.resize(index_.size());
+  x_.resize(index_.size());
+  y_.resize(index_.size());
+}
+
+/* Least squares x = a + b*y over the face nearest to us, sides of the truck
+ * (points deeper than depth_tolerance_) are left out */
+bool ObjectDetector::fitRear(size_t begin, size_t end, obstacle_detector::CircleObstacle* circle){
+  float near_x = -1e9f;
+  for (size_t i = begin; i < end; i++) {
+    if (x_[i] > near_x) near_x = x_[i];
+  }
+
+  float n = 0.0f, sy = 0.0f, sx = 0.0f, syy = 0.0f, sxy = 0.0f;
+  float y_min = 1e9f, y_max = -1e9f;
+  for (size_t i = begin; i < end; i++) {
+    if (near_x - x_[i] > depth_tolerance_) continue;
+    n += 1.0f;
+    sy += y_[i];
+    sx += x_[i];
+    syy += y_[i] * y_[i];
+    sxy += x_[i] * y_[i];
+    if (y_[i] < y_min) y_min = y_[i];
+    if (y_[i] > y_max) y_max = y_[i];
+  }
+  if (n < 2.0f) return false;
+
+  const float y_c = sy / n;
+  float x_c = sx / n;
+  const float den = n * syy - sy * sy;
+  if (fabs(den) > 1e-6f) {
+    const float b = (n * sxy - sx * sy) / den;
+    const float a = (sx - b * sy) / n;
+    x_c = a + b * y_c;
+  }
+
+  circle->center.x = x_c;
+  circle->center.y = y_c;
+  circle->center.z = 0.0;
+  circle->velocity.x = 0.0;
+  circle->velocity.y = 0.0;
+  circle->radius = (y_max - y_min) / 2.0f;
+  circle->true_radius = 0.0;  // center already sits on the rear face
+  return true;
+}
+
+obstacle_detector::Obstacles::ConstPtr ObjectDetector::detect(const sensor_msgs::LaserScan::ConstPtr& scan){
+  obstacle_detector::Obstacles::Ptr obstacles(new obstacle_detector::Obstacles);
+  obstacles->header = scan->header;
+
+  updateSector(*scan);
+  const size_t size = index_.size();
+  const float min_range = std::max(min_range_, scan->range_min);
+  const float max_range = std::min(max_range_, scan->range_max);
+
+  /* invalid returns are pushed out of range so the conversion stays branch free */
+  for (size_t k = 0; k < size; k++) {
+    const float r = scan->ranges[index_[k]];
+    range_[k] = (std::isfinite(r) && r >= min_range && r <= max_range) ? r : 0.0f;
+  }
+  for (size_t k = 0; k < size; k++) {
+    x_[k] = range_[k] * cos_[k];
+    y_[k] = range_[k] * sin_[k];
+  }
+
+  /* drop invalid returns, angular order is kept for clustering */
+  size_t valid = 0;
+  for (size_t k = 0; k < size; k++) {
+    if (range_[k] == 0.0f) continue;
+    range_[valid] = range_[k];
+    x_[valid] = x_[k];
+    y_[valid] = y_[k];
+    valid++;
+  }
+
+  /* split where neighbours are further apart than the range scaled gap */
+  size_t begin = 0;
+  for (size_t k = 1; k <= valid; k++) {
+    bool split = (k == valid);
+    if (!split) {
+      const float dx = x_[k] - x_[k - 1];
+      const float dy = y_[k] - y_[k - 1];
+      const float gap = cluster_gap_ + cluster_proportion_ * range_[k];
+      split = (dx * dx + dy * dy) > gap * gap;
+    }
+    if (!split) continue;
+
+    obstacle_detector::CircleObstacle circle;
+    if ((int)(k - begin) >= min_points_ && fitRear(begin, k, &circle)) {
+      obstacles->circles.push_back(circle);
+    }
+    begin = k;
   }
+  return obstacles;
 }
 
 }
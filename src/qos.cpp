@@ -0,0 +1,51 @@
+#include "qos/qos.hpp"
+
+#include <ros/ros.h>
+
+namespace QoS {
+
+Scheduler::Scheduler(const std::string& name)
+	: name_(name){
+}
+
+void Scheduler::configure(double budget_ms, int max_level, double degrade_ratio, double recover_ratio, int degrade_cycles, int recover_cycles){
+	budget_ = budget_ms;
+	max_level_ = max_level;
+	degrade_ratio_ = degrade_ratio;
+	recover_ratio_ = recover_ratio;
+	degrade_cycles_ = degrade_cycles;
+	recover_cycles_ = recover_cycles;
+	if (level_ > max_level_) level_ = max_level_;
+}
+
+int Scheduler::update(double cycle_ms){
+	avg_ = (avg_ == 0.0) ? cycle_ms : avg_ + 0.2 * (cycle_ms - avg_);
+	if (budget_ <= 0.0) return level_;
+
+	if (cycle_ms > budget_ * degrade_ratio_) {
+		over_++;
+		under_ = 0;
+	}
+	else if (avg_ < budget_ * recover_ratio_) {
+		under_++;
+		over_ = 0;
+	}
+	else {
+		over_ = 0;
+		under_ = 0;
+	}
+
+	if (over_ >= degrade_cycles_ && level_ < max_level_) {
+		level_++;
+		over_ = 0;
+		ROS_WARN("[%s] QoS level %d (%.1f ms, budget %.1f ms)", name_.c_str(), level_, avg_, budget_);
+	}
+	else if (under_ >= recover_cycles_ && level_ > 0) {
+		level_--;
+		under_ = 0;
+		ROS_WARN("[%s] QoS level %d (%.1f ms, budget %.1f ms)", name_.c_str(), level_, avg_, budget_);
+	}
+	return level_;
+}
+
+}
@@ -0,0 +1,124 @@
+#include "rt_util/rt_util.hpp"
+
+#include <cmath>
+#include <string.h>
+#include <errno.h>
+#include <alloca.h>
+#include <ros/ros.h>
+
+namespace RTUtil {
+
+bool setThreadAttr(std::thread& thread, int core, int priority, const char* name){
+	return setThreadAttr(thread.native_handle(), core, priority, name);
+}
+
+bool setThreadAttr(pthread_t thread, int core, int priority, const char* name){
+	bool ok = true;
+
+	if (core >= 0) {
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(core, &cpuset);
+		if (pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset) != 0) {
+			ROS_WARN("[RTUtil] failed to pin %s thread to core %d", name, core);
+			ok = false;
+		}
+	}
+
+	if (priority > 0) {
+		struct sched_param param;
+		param.sched_priority = priority;
+		int ret = pthread_setschedparam(thread, SCHED_FIFO, &param);
+		if (ret != 0) {
+			ROS_WARN("[RTUtil] SCHED_FIFO %d for %s thread: %s", priority, name, strerror(ret));
+			ok = false;
+		}
+	}
+
+	pthread_setname_np(thread, std::string(name).substr(0, 15).c_str());
+	return ok;
+}
+
+bool lockMemory(size_t stack_bytes){
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+		ROS_WARN("[RTUtil] mlockall: %s", strerror(errno));
+		return false;
+	}
+
+	/* prefault the stack of the calling thread */
+	volatile unsigned char* stack = (volatile unsigned char*)alloca(stack_bytes);
+	for (size_t i = 0; i < stack_bytes; i += 4096) {
+		stack[i] = 0;
+	}
+	return true;
+}
+
+DeadlineMonitor::DeadlineMonitor(const std::string& name, double budget_ms)
+	: name_(name){
+	setBudget(budget_ms);
+}
+
+double DeadlineMonitor::nowMs(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000.0) + (ts.tv_nsec / 1000000.0);
+}
+
+void DeadlineMonitor::setBudget(double budget_ms){
+	stats_.budget = budget_ms;
+	snapshot_.store(stats_);
+}
+
+void DeadlineMonitor::begin(){
+	begin_ = nowMs();
+	if (prev_begin_ != 0.0) {
+		double period = begin_ - prev_begin_;
+		if (stats_.periods == 0 || period < stats_.period_min) stats_.period_min = period;
+		if (period > stats_.period_max) stats_.period_max = period;
+		stats_.period_sum += period;
+		stats_.period_sq_sum += period * period;
+		stats_.periods++;
+	}
+	prev_begin_ = begin_;
+}
+
+void DeadlineMonitor::end(){
+	double exec = nowMs() - begin_;
+	if (stats_.cycles > 3000) reset();
+
+	stats_.cycles++;
+	stats_.exec_sum += exec;
+	if (exec > stats_.exec_max) stats_.exec_max = exec;
+	if (stats_.budget > 0.0 && exec > stats_.budget) stats_.misses++;
+	snapshot_.store(stats_);
+}
+
+void DeadlineMonitor::reset(){
+	double budget = stats_.budget;
+	stats_ = DeadlineStats();
+	stats_.budget = budget;
+	snapshot_.store(stats_);
+}
+
+double DeadlineMonitor::jitter(const DeadlineStats& stats){
+	if (stats.periods < 2) return 0.0;
+	double mean = stats.period_sum / stats.periods;
+	double var = (stats.period_sq_sum / stats.periods) - (mean * mean);
+	return var > 0.0 ? sqrt(var) : 0.0;
+}
+
+double DeadlineMonitor::jitter() const{
+	return jitter(snapshot_.load());
+}
+
+std::string DeadlineMonitor::summary() const{
+	char buf[192];
+	const DeadlineStats stats = snapshot_.load();
+	double exec_avg = stats.cycles ? stats.exec_sum / stats.cycles : 0.0;
+	double period_avg = stats.periods ? stats.period_sum / stats.periods : 0.0;
+	snprintf(buf, sizeof(buf), "%s: exec %.2f avg / %.2f max ms, period %.2f (%.2f ~ %.2f) jitter %.3f ms, miss %u/%u (budget %.1f ms)",
+		name_.c_str(), exec_avg, stats.exec_max, period_avg, stats.period_min, stats.period_max, jitter(stats), stats.misses, stats.cycles, stats.budget);
+	return std::string(buf);
+}
+
+}
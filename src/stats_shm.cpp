@@ -0,0 +1,105 @@
+#include "stats_shm/stats_shm.hpp"
+
+#include <new>
+#include <dirent.h>
+
+namespace StatsShm {
+
+static std::string shmName(const std::string& name){
+	return std::string("/") + STATS_PREFIX + name;
+}
+
+StatsWriter::StatsWriter(const std::string& name)
+	: name_(shmName(name)){
+	memset(&data_, 0, sizeof(data_));
+
+	int fd = shm_open(name_.c_str(), O_CREAT | O_RDWR, 0644);
+	if (fd < 0) {
+		perror("shm_open");
+		return;
+	}
+	if (ftruncate(fd, sizeof(StatsBlock)) < 0) {
+		perror("ftruncate");
+		close(fd);
+		return;
+	}
+	void* addr = mmap(NULL, sizeof(StatsBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) {
+		perror("mmap");
+		return;
+	}
+	block_ = new (addr) StatsBlock(data_);
+}
+
+StatsWriter::~StatsWriter(){
+	if (block_) {
+		block_->~StatsBlock();
+		munmap(block_, sizeof(StatsBlock));
+		shm_unlink(name_.c_str());
+	}
+}
+
+void StatsWriter::begin(const char* title){
+	snprintf(data_.title, sizeof(data_.title), "%s", title);
+	data_.lines = 0;
+}
+
+void StatsWriter::printf(const char* fmt, ...){
+	if (data_.lines >= STATS_LINES) return;
+
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(data_.line[data_.lines], STATS_LINE_LEN, fmt, args);
+	va_end(args);
+	data_.lines++;
+}
+
+void StatsWriter::commit(){
+	if (!block_) return;
+
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	data_.updated_us = (uint64_t)now.tv_sec * 1000000ULL + now.tv_usec;
+	block_->store(data_);
+}
+
+StatsReader::StatsReader(const std::string& name)
+	: name_(name){
+	int fd = shm_open(shmName(name).c_str(), O_RDONLY, 0);
+	if (fd < 0) return;
+
+	void* addr = mmap(NULL, sizeof(StatsBlock), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) return;
+	block_ = static_cast<const StatsBlock*>(addr);
+}
+
+StatsReader::~StatsReader(){
+	if (block_) munmap(const_cast<StatsBlock*>(block_), sizeof(StatsBlock));
+}
+
+bool StatsReader::read(StatsData* data) const{
+	if (!block_) return false;
+	*data = block_->load();
+	if (data->lines > STATS_LINES) data->lines = STATS_LINES;
+	return true;
+}
+
+std::vector<std::string> StatsReader::list(){
+	std::vector<std::string> names;
+	DIR* dir = opendir("/dev/shm");
+	if (!dir) return names;
+
+	const size_t prefix = strlen(STATS_PREFIX);
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		if (strncmp(entry->d_name, STATS_PREFIX, prefix) == 0) {
+			names.push_back(std::string(entry->d_name + prefix));
+		}
+	}
+	closedir(dir);
+	return names;
+}
+
+}
@@ -0,0 +1,114 @@
+#include "vehicle_tracker/vehicle_tracker.hpp"
+
+namespace VehicleTracker {
+
+static inline float circleRange(const obstacle_detector::CircleObstacle& circle){
+	return -circle.center.x - circle.true_radius;
+}
+
+Tracker::Tracker(ros::NodeHandle nh)
+	: nodeHandle_(nh){
+	nodeHandle_.param("tracker/gate_range", gate_range_, 0.3f);
+	nodeHandle_.param("tracker/gate_lateral", gate_lateral_, 0.2f);
+	nodeHandle_.param("tracker/lane_half_width", lane_half_width_, 0.25f);
+	nodeHandle_.param("tracker/alpha", alpha_, 0.6f);
+	nodeHandle_.param("tracker/beta", beta_, 0.2f);
+	nodeHandle_.param("tracker/max_rate", max_rate_, 2.0f);
+	nodeHandle_.param("tracker/max_predict", max_predict_, 0.2);
+	nodeHandle_.param("tracker/confirm_hits", confirm_hits_, 2);
+	nodeHandle_.param("tracker/max_coast", max_coast_, 3);
+}
+
+void Tracker::reset(){
+	track_ = Track();
+}
+
+bool Tracker::associate(const obstacle_detector::Obstacles& scan, float pred_range, int* best) const{
+	float best_cost = 1.0f;  // normalized, 1 = on the gate edge
+	*best = -1;
+	for (size_t i = 0; i < scan.circles.size(); i++) {
+		const float dr = (circleRange(scan.circles[i]) - pred_range) / gate_range_;
+		const float dl = (scan.circles[i].center.y - track_.lateral) / gate_lateral_;
+		const float cost = dr * dr + dl * dl;
+		if (cost < best_cost) {
+			best_cost = cost;
+			*best = i;
+		}
+	}
+	return *best >= 0;
+}
+
+bool Tracker::acquire(const obstacle_detector::Obstacles& scan, int* best) const{
+	float best_range = 10.1f;
+	*best = -1;
+	for (size_t i = 0; i < scan.circles.size(); i++) {
+		const float range = circleRange(scan.circles[i]);
+		if (range < 0.0f || fabs(scan.circles[i].center.y) > lane_half_width_) continue;
+		if (range < best_range) {
+			best_range = range;
+			*best = i;
+		}
+	}
+	return *best >= 0;
+}
+
+const Track& Tracker::update(const obstacle_detector::Obstacles::ConstPtr& scan){
+	if (!scan) return track_;
+
+	const ros::Time stamp = scan->header.stamp.isZero() ? ros::Time::now() : scan->header.stamp;
+	int idx;
+
+	if (track_.hits > 0) {
+		double dt = (stamp - track_.stamp).toSec();
+		if (dt < 0.0) dt = 0.0;
+		const float pred_range = track_.range + track_.range_rate * dt;
+
+		if (associate(*scan, pred_range, &idx)) {
+			const obstacle_detector::CircleObstacle& circle = scan->circles[idx];
+			const float residual = circleRange(circle) - pred_range;
+			track_.range = pred_range + alpha_ * residual;
+			if (dt > 0.0) {
+				track_.range_rate += beta_ * residual / dt;
+				if (track_.range_rate > max_rate_) track_.range_rate = max_rate_;
+				if (track_.range_rate < -max_rate_) track_.range_rate = -max_rate_;
+			}
+			track_.lateral = circle.center.y;
+			track_.angle = atanf(circle.center.y / circle.center.x) * (180.0f / M_PI);
+			track_.stamp = stamp;
+			track_.hits++;
+			track_.misses = 0;
+			if (track_.hits >= confirm_hits_) track_.valid = true;
+			return track_;
+		}
+
+		// coast on the prediction, the gate stays where the truck should be
+		track_.range = pred_range;
+		track_.stamp = stamp;
+		if (++track_.misses <= max_coast_) return track_;
+		reset();
+	}
+
+	if (acquire(*scan, &idx)) {
+		const obstacle_detector::CircleObstacle& circle = scan->circles[idx];
+		track_.range = circleRange(circle);
+		track_.range_rate = 0.0f;
+		track_.lateral = circle.center.y;
+		track_.angle = atanf(circle.center.y / circle.center.x) * (180.0f / M_PI);
+		track_.stamp = stamp;
+		track_.hits = 1;
+		track_.misses = 0;
+		track_.valid = (confirm_hits_ <= 1);
+	}
+	return track_;
+}
+
+float Tracker::predictRange(const ros::Time& now) const{
+	if (!track_.valid) return track_.range;
+
+	double dt = (now - track_.stamp).toSec();
+	if (dt < 0.0) dt = 0.0;
+	if (dt > max_predict_) dt = max_predict_;
+	return track_.range + track_.range_rate * dt;
+}
+
+}
@@ -1,7 +1,8 @@
 #include "zmq_class/zmq_class.h"
+#include "zmq_wire/zmq_wire.hpp"
 
-ZMQ_CLASS::ZMQ_CLASS(ros::NodeHandle nh)
-  :nodeHandle_(nh), context_(1)	//zmq constructor dealing with the initialisation and termination of a zmq context
+ZMQ_CLASS::ZMQ_CLASS(ros::NodeHandle nh, zmq::context_t* context)
+  :nodeHandle_(nh), own_context_(context ? nullptr : new zmq::context_t(1)), context_(context ? *context : *own_context_)	//zmq constructor dealing with the initialisation and termination of a zmq context
 {
   if(!readParameters())
   {
@@ -31,10 +32,11 @@ ZMQ_CLASS::~ZMQ_CLASS()
     dsh_socket_.close();
     delete dsh_recv_;
   }
+  if(req_img_flag_) req_img_socket_.close();
+  if(rep_img_flag_) rep_img_socket_.close();
+  monitors_.clear();
 
-  delete img_recv_;
-
-  context_.close();
+  if(own_context_) context_.close();
 }
 
 void ZMQ_CLASS::init()
@@ -45,53 +47,212 @@ void ZMQ_CLASS::init()
   if (rep_flag_) rep_recv_ = new ZmqData;
   if (req_flag_) req_recv_ = new ZmqData;
   if (dsh_flag_) dsh_recv_ = new ZmqData;
-  img_recv_ = new ImgData;
 
-  /* Initialize Tcp client(Request) Socket */
+  /* Initialize Tcp client(Dealer) Socket, sends never wait for a reply */
   if(req_flag_)
   {
-    req_socket_ = zmq::socket_t(context_, ZMQ_REQ); 
-    req_socket_.connect(tcpreq_ip_);
-    req_socket_.setsockopt(ZMQ_RCVTIMEO, -1);  //timeout (infinite) 
+    req_socket_ = zmq::socket_t(context_, ZMQ_DEALER); 
+    req_socket_.setsockopt(ZMQ_SNDHWM, 2);  //keep only fresh telemetry queued
+    req_socket_.setsockopt(ZMQ_IMMEDIATE, 1);  //no queueing before the peer is up
     req_socket_.setsockopt(ZMQ_LINGER, 0); 
+    linkOptions(req_socket_);
+    monitor(req_socket_, &req_health_, "req", tcpreq_ip_);
+    req_socket_.connect(tcpreq_ip_);
   }
 
-  /* Initialize Tcp server(Reply) Socket */
+  /* Initialize Tcp server(Router) Socket, serves DEALER and REQ peers */
   if(rep_flag_)
   {
-    rep_socket_ = zmq::socket_t(context_, ZMQ_REP);
+    rep_socket_ = zmq::socket_t(context_, ZMQ_ROUTER);
+    rep_socket_.setsockopt(ZMQ_LINGER, 0); 
+    linkOptions(rep_socket_);
+    monitor(rep_socket_, &rep_health_, "rep", tcprep_ip_);
     rep_socket_.bind(tcprep_ip_);
   }
 
-  /* Initialize Udp send(Radio) Socket */
+  /* Initialize Udp send(Radio) Socket, binds on ipc / inproc / tcp so several dishes can join */
+  bool udp = (udp_ip_.compare(0, 6, "udp://") == 0);
   if(rad_flag_)
   {
     rad_socket_ = zmq::socket_t(context_, ZMQ_RADIO);
-    rad_socket_.connect(udp_ip_);
+    monitor(rad_socket_, &rad_health_, "radio", udp_ip_);
+    if(udp) rad_socket_.connect(udp_ip_);
+    else rad_socket_.bind(udp_ip_);
   }
 
   /* Initialize Udp recv(Dish) Socket */
   if(dsh_flag_)
   {
     dsh_socket_ = zmq::socket_t(context_, ZMQ_DISH);
-    dsh_socket_.bind(udp_ip_);
+    monitor(dsh_socket_, &dsh_health_, "dish", udp_ip_);
+    if(udp) dsh_socket_.bind(udp_ip_);
+    else dsh_socket_.connect(udp_ip_);
     dsh_socket_.join(dsh_group_.c_str());
   }
 
+  /* Image client, relaxed so the next frame can go out while an ack is missing */
   if(req_img_flag_)
   {
     req_img_socket_ = zmq::socket_t(context_, ZMQ_REQ);
-    req_img_socket_.connect(tcpreq_img_ip_);
+    req_img_socket_.setsockopt(ZMQ_REQ_RELAXED, 1);
+    req_img_socket_.setsockopt(ZMQ_REQ_CORRELATE, 1);  //late acks of an old frame are dropped
     req_img_socket_.setsockopt(ZMQ_LINGER, 0); 
+    linkOptions(req_img_socket_);
+    monitor(req_img_socket_, &req_img_health_, "req_img", tcpreq_img_ip_);
+    req_img_socket_.connect(tcpreq_img_ip_);
   }
 
   if(rep_img_flag_)
   {
     rep_img_socket_ = zmq::socket_t(context_, ZMQ_REP);
+    linkOptions(rep_img_socket_);
+    monitor(rep_img_socket_, &rep_img_health_, "rep_img", tcprep_img_ip_);
     rep_img_socket_.bind(tcprep_img_ip_);
   }
 }
 
+/* Fast reconnect, and ZMTP heartbeats so a dead peer is seen as a disconnect */
+void ZMQ_CLASS::linkOptions(zmq::socket_t& socket)
+{
+  socket.setsockopt(ZMQ_RECONNECT_IVL, RECONNECT_IVL);
+  socket.setsockopt(ZMQ_RECONNECT_IVL_MAX, RECONNECT_IVL_MAX);
+  socket.setsockopt(ZMQ_HEARTBEAT_IVL, heartbeat_);
+  socket.setsockopt(ZMQ_HEARTBEAT_TIMEOUT, heartbeat_ * 3);
+}
+
+/***********/
+/* Monitor */
+/***********/
+#ifdef ZMQ_EVENT_HANDSHAKE_FAILED_PROTOCOL
+#define HANDSHAKE_FAILED_EVENTS (ZMQ_EVENT_HANDSHAKE_FAILED_NO_DETAIL | ZMQ_EVENT_HANDSHAKE_FAILED_PROTOCOL | ZMQ_EVENT_HANDSHAKE_FAILED_AUTH)
+#else
+#define HANDSHAKE_FAILED_EVENTS 0
+#endif
+
+/* Connection events of one socket, read by the reactor like any other socket */
+void ZMQ_CLASS::monitor(zmq::socket_t& socket, LinkHealth* link, const char* name, const std::string& endpoint)
+{
+  link->name = name;
+  link->enabled = true;
+  link->monitored = (endpoint.compare(0, 9, "inproc://") != 0 && endpoint.compare(0, 6, "udp://") != 0);  //no connections to watch
+  if(!link->monitored) return;
+
+  std::string addr = (boost::format("inproc://monitor.%s.%p") % name % this).str();
+  int events = ZMQ_EVENT_CONNECTED | ZMQ_EVENT_ACCEPTED | ZMQ_EVENT_DISCONNECTED | ZMQ_EVENT_CONNECT_RETRIED | HANDSHAKE_FAILED_EVENTS;
+  if(zmq_socket_monitor(socket, addr.c_str(), events) != 0) {
+    ROS_WARN("[ZMQ] %s monitor failed, link health unknown", name);
+    link->monitored = false;
+    return;
+  }
+
+  monitors_.emplace_back(new zmq::socket_t(context_, ZMQ_PAIR));
+  zmq::socket_t* mon = monitors_.back().get();
+  mon->connect(addr);
+  readers_.push_back({ *mon, [mon, link]() {
+    zmq::message_t event, addr_msg;
+    while(mon->recv(&event, ZMQ_DONTWAIT)) {
+      if(event.more()) mon->recv(&addr_msg, 0);
+      if(event.size() < 6) continue;
+      uint16_t id;
+      memcpy(&id, event.data(), sizeof(id));
+      if(id == ZMQ_EVENT_CONNECTED || id == ZMQ_EVENT_ACCEPTED) {
+        link->peers++;
+        link->connects++;
+      }
+      else if(id == ZMQ_EVENT_DISCONNECTED) {
+        if(link->peers > 0) link->peers--;
+        link->disconnects++;
+        ROS_WARN("[ZMQ] %s peer disconnected", link->name);
+      }
+      else if(id == ZMQ_EVENT_CONNECT_RETRIED) link->retries++;
+      else if(id & HANDSHAKE_FAILED_EVENTS) link->handshake_fails++;
+    }
+  } });
+}
+
+/* Notes the newest packet from a peer. An ack in it closes an NTP exchange:
+ * t1 our send, t2 = t3 - ack delay, t3 its send_stamp, t4 now. That gives one
+ * RTT sample and one clock sample, data's stamps are then moved to our clock */
+void ZMQ_CLASS::received(LinkHealth* link, ZmqPeer* peer, uint32_t seq, const ZmqWire::Ack& ack, ZmqData* data)
+{
+  auto now = std::chrono::steady_clock::now();
+  int64_t now_us = ClockSync::PeerClock::nowUs();
+  if(!peer->rx_valid || (int32_t)(seq - peer->rx_seq) > 0) {
+    peer->rx_seq = seq;
+    peer->rx_time = now;
+    peer->rx_valid = true;
+  }
+
+  int slot = ack.seq % SEND_LOG;
+  if(ack.valid && link->sent_seq[slot] == ack.seq && link->sent[slot] != 0) {
+    float rtt = (now.time_since_epoch().count() - link->sent[slot] - ack.delay_us * 1000LL) / 1e6f;
+    if(rtt < 0.0f) rtt = 0.0f;
+    peer->rtt = (peer->rtt < 0.0f) ? rtt : 0.875f * peer->rtt + 0.125f * rtt;
+    rttSample(link, rtt);
+
+    int64_t t3 = ClockSync::PeerClock::toUs(data->send_stamp);
+    peer->clock.addExchange(link->sent_wall[slot], t3 - ack.delay_us, t3, now_us);
+    if(peer == &req_server_) {
+      link->clock = peer->clock.offsetUs(now_us) / 1000.0;
+      link->skew = peer->clock.skewPpm();
+    }
+  }
+
+  if(peer->clock.valid()) {
+    peer->clock.toLocal(&data->send_stamp);
+    peer->clock.toLocal(&data->image_stamp);
+    data->clock_synced = true;
+  }
+}
+
+/* Smoothed RTT and deviation, RFC 6298 gains */
+void ZMQ_CLASS::rttSample(LinkHealth* link, float rtt)
+{
+  float srtt = link->rtt;
+  if(srtt < 0.0f) {
+    link->rtt = rtt;
+    link->rtt_var = rtt / 2.0f;
+  }
+  else {
+    link->rtt_var = 0.75f * link->rtt_var + 0.25f * fabsf(srtt - rtt);
+    link->rtt = 0.875f * srtt + 0.125f * rtt;
+  }
+  if(rtt > link->rtt_max) link->rtt_max = rtt;
+}
+
+std::vector<std::string> ZMQ_CLASS::healthReport()
+{
+  std::vector<std::string> lines;
+  for(LinkHealth* link : { &req_health_, &rep_health_, &rad_health_, &dsh_health_, &req_img_health_, &rep_img_health_ }) {
+    if(!link->enabled) continue;
+    std::string line = (boost::format("ZMQ %-8s: ") % link->name).str();
+    if(!link->monitored) line += "unmonitored";
+    else line += (boost::format("%s %d, conn %u / disc %u / retry %u / hs fail %u")
+      % (link->up() ? "up" : "DOWN") % link->peers.load() % link->connects.load()
+      % link->disconnects.load() % link->retries.load() % link->handshake_fails.load()).str();
+    if(link->rtt >= 0.0f) {
+      line += (boost::format(", rtt %.2f +- %.2f ms (max %.2f)") % link->rtt.load() % link->rtt_var.load() % link->rtt_max.exchange(0.0f)).str();
+    }
+    if(!std::isnan(link->clock.load())) line += (boost::format(", clock %+.3f ms (%+.1f ppm)") % link->clock.load() % link->skew.load()).str();
+    if(link->timeouts) line += (boost::format(", %u timeouts") % link->timeouts.load()).str();
+    lines.push_back(line);
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  std::scoped_lock lock(peers_mutex_);
+  for(size_t i = 0; i < rep_peers_.size(); i++) {
+    const ZmqPeer& peer = rep_peers_[i];
+    double seen = std::chrono::duration<double, std::milli>(now - peer.last_seen).count();
+    std::string line = (boost::format("ZMQ peer %-3zu: %s, rtt %.2f ms, seen %.0f ms ago")
+      % i % (peer.lockstep ? "REQ" : "DEALER") % peer.rtt % seen).str();
+    if(peer.clock.valid()) {
+      line += (boost::format(", clock %+.3f ms (%+.1f ppm)") % (peer.clock.offsetUs(ClockSync::PeerClock::nowUs()) / 1000.0) % peer.clock.skewPpm()).str();
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
 std::string ZMQ_CLASS::getIPAddress(){
   std::string ipAddress="Unable to get IP Address";
   struct ifaddrs *interfaces = NULL;
@@ -117,6 +278,13 @@ std::string ZMQ_CLASS::getIPAddress(){
   }
 }
 
+/* address:port unless a full endpoint is configured */
+static std::string endpoint(const std::string& given, const std::string& addr, const std::string& port)
+{
+  if(!given.empty()) return given;
+  return addr + ":" + port;
+}
+
 bool ZMQ_CLASS::readParameters()
 {
   std::string tcp_ip_server, tcp_ip_client, tcp_img_ip_server, tcp_img_ip_client, tcpreq_port, tcprep_port, tcpreq_img_port, tcprep_img_port;
@@ -138,6 +306,13 @@ bool ZMQ_CLASS::readParameters()
   nodeHandle_.param("udp_ip/port",udp_port,std::string("9090"));
   nodeHandle_.param("udp_ip/send_group",rad_group_,std::string("FV"));
   nodeHandle_.param("udp_ip/recv_group",dsh_group_,std::string("LV"));
+
+  //full endpoints (tcp://, ipc://, inproc://, udp://) override the address and port above
+  nodeHandle_.param("tcp_ip/req_endpoint",tcpreq_ip_,std::string(""));
+  nodeHandle_.param("tcp_ip/rep_endpoint",tcprep_ip_,std::string(""));
+  nodeHandle_.param("tcpimg_ip/req_endpoint",tcpreq_img_ip_,std::string(""));
+  nodeHandle_.param("tcpimg_ip/rep_endpoint",tcprep_img_ip_,std::string(""));
+  nodeHandle_.param("udp_ip/endpoint",udp_ip_,std::string(""));
   
   nodeHandle_.param("socket/req_flag",req_flag_,false);
   nodeHandle_.param("socket/rep_flag",rep_flag_,false);
@@ -145,163 +320,377 @@ bool ZMQ_CLASS::readParameters()
   nodeHandle_.param("socket/dsh_flag",dsh_flag_,false);
   nodeHandle_.param("socket/req_img_flag",req_img_flag_,false);
   nodeHandle_.param("socket/rep_img_flag",rep_img_flag_,false);
+  nodeHandle_.param("socket/send_period_ms",send_period_,SEND_PERIOD);
+  nodeHandle_.param("socket/peer_timeout_ms",peer_timeout_,PEER_TIMEOUT);
+  nodeHandle_.param("socket/heartbeat_ms",heartbeat_,HEARTBEAT);
+  nodeHandle_.param("socket/beacon_half",beacon_half_,true);
+  nodeHandle_.param("socket/beacon_heartbeat_ms",beacon_heartbeat_,BEACON_HEARTBEAT);
+  nodeHandle_.param("socket/beacon_timeout_ms",beacon_timeout_,BEACON_TIMEOUT);
+
+  tcpreq_ip_ = endpoint(tcpreq_ip_, tcp_ip_client, tcpreq_port);
+  tcprep_ip_ = endpoint(tcprep_ip_, tcp_ip_server, tcprep_port);
+  tcpreq_img_ip_ = endpoint(tcpreq_img_ip_, tcp_img_ip_client, tcpreq_img_port);
+  tcprep_img_ip_ = endpoint(tcprep_img_ip_, tcp_img_ip_server, tcprep_img_port);
+  udp_ip_ = endpoint(udp_ip_, udp_ip, udp_port);
 
-  //set request socket ip
-  tcpreq_ip_ = tcp_ip_client;
-  tcpreq_ip_.append(":");
-  tcpreq_ip_.append(tcpreq_port);
-
-  //set reply socket ip
-  tcprep_ip_ = tcp_ip_server;
-  tcprep_ip_.append(":");
-  tcprep_ip_.append(tcprep_port);
-
-  //set request socket ip
-  tcpreq_img_ip_ = tcp_img_ip_client;
-  tcpreq_img_ip_.append(":");
-  tcpreq_img_ip_.append(tcpreq_img_port);
+  return true;
+}
 
-  //set reply socket ip
-  tcprep_img_ip_ = tcp_img_ip_server;
-  tcprep_img_ip_.append(":");
-  tcprep_img_ip_.append(tcprep_img_port);
+/* Stamps send_data and encodes it into buf, seq counts packets per link.
+ * With a link the send time is logged, with a peer its newest packet is acked */
+size_t ZMQ_CLASS::pack(ZmqData* send_data, uint8_t type, uint32_t* seq, uint8_t* buf, LinkHealth* link, const ZmqPeer* peer)
+{
+  auto now = std::chrono::steady_clock::now();
+  ZmqWire::Ack ack;
+  if(peer && peer->rx_valid) {
+    ack.seq = peer->rx_seq;
+    ack.delay_us = std::chrono::duration_cast<std::chrono::microseconds>(now - peer->rx_time).count();
+    ack.valid = true;
+  }
+  if(link) {
+    link->sent[*seq % SEND_LOG] = now.time_since_epoch().count();
+    link->sent_seq[*seq % SEND_LOG] = *seq;
+  }
 
-  //set radio/dish socket ip
-  udp_ip_ = udp_ip;
-  udp_ip_.append(":");
-  udp_ip_.append(udp_port);
+  gettimeofday(&send_data->send_stamp, NULL);
+  if(link) link->sent_wall[(*seq) % SEND_LOG] = ClockSync::PeerClock::toUs(send_data->send_stamp);
+  return ZmqWire::encode(*send_data, static_cast<ZmqWire::MsgType>(type), (*seq)++, buf, &ack);
+}
 
-  return true;
+/* Decodes one payload frame, recv_data is only written when it checks out */
+bool ZMQ_CLASS::unpack(const zmq::message_t& frame, ZmqData* recv_data, uint32_t* seq, ZmqWire::Ack* ack)
+{
+  if(ZmqWire::decode(frame.data(), frame.size(), recv_data, seq, ack)) return true;
+  wire_errors_++;
+  return false;
 }
 
-void* ZMQ_CLASS::requestZMQ(ZmqData *send_data)  // client: send -> recv
-{ 
-  if(req_socket_.connected() && !controlDone_)
-  {
-    zmq::message_t recv_msg(DATASIZE), send_msg(DATASIZE);
+/* Reads the rest of a multipart message, the last frame is the payload */
+bool ZMQ_CLASS::recvPayload(zmq::socket_t& socket, ZmqData* recv_data, uint32_t* seq, ZmqWire::Ack* ack)
+{
+  zmq::message_t frame;
+  do {
+    socket.recv(&frame, 0);
+  } while(frame.more());
 
-    //send
-    memcpy(send_msg.data(), send_data, DATASIZE);
-    req_socket_.send(send_msg);
+  return unpack(frame, recv_data, seq, ack);
+}
 
-    //recv
-    req_socket_.recv(&recv_msg, 0);
-    memcpy(req_recv_, recv_msg.data(), DATASIZE);
-//    req_recv_ = static_cast<ZmqData *>(recv_msg.data()); 
-  }
+/***********/
+/* Reactor */
+/***********/
+void ZMQ_CLASS::addTimer(int period_ms, std::function<void()> fn)
+{
+  Timer timer;
+  timer.period = std::chrono::milliseconds(period_ms);
+  timer.next = std::chrono::steady_clock::now();
+  timer.fn = fn;
+  timers_.push_back(timer);
 }
 
-void* ZMQ_CLASS::replyZMQ(ZmqData *send_data)  //server: recv -> send
+void ZMQ_CLASS::spin()
 {
-  if(rep_socket_.connected() && !controlDone_)
+  std::vector<zmq::pollitem_t> items;
+  for(auto& reader : readers_) items.push_back({ reader.socket, 0, ZMQ_POLLIN, 0 });
+
+  while(!controlDone_)
   {
-    zmq::message_t recv_msg(DATASIZE), send_msg(DATASIZE);
+    //sleep until a socket is readable or the next timer is due
+    auto now = std::chrono::steady_clock::now();
+    long timeout = SPIN_TIMEOUT;
+    for(auto& timer : timers_) {
+      long due = std::chrono::duration_cast<std::chrono::milliseconds>(timer.next - now).count();
+      timeout = std::max(0L, std::min(timeout, due));
+    }
+    zmq::poll(items.data(), items.size(), timeout);
 
-    //recv
-    rep_socket_.recv(&recv_msg, 0);
-    memcpy(rep_recv_, recv_msg.data(), DATASIZE);
-//    rep_recv_ = static_cast<ZmqData *>(recv_msg.data());
+    for(size_t i = 0; i < items.size(); i++) {
+      if(items[i].revents & ZMQ_POLLIN) readers_[i].fn();
+    }
 
-    //send
-    memcpy(send_msg.data(), send_data, DATASIZE);
-    rep_socket_.send(send_msg);
-    
+    now = std::chrono::steady_clock::now();
+    for(auto& timer : timers_) {
+      if(now < timer.next) continue;
+      timer.fn();
+      timer.next += timer.period;
+      if(timer.next < now) timer.next = now + timer.period;  //skip missed ticks, no bursts
+    }
   }
+}
 
+/* Client: replies are handled as they arrive, sends run every send_period */
+void ZMQ_CLASS::onRequest(ZmqData* send_data, DataFn fill, DataFn recv)
+{
+  if(!req_flag_) return;
+
+  readers_.push_back({ req_socket_, [this, recv]() {
+    zmq::pollitem_t items[] = { { req_socket_, 0, ZMQ_POLLIN, 0 } };
+    do {
+      uint32_t seq;
+      ZmqWire::Ack ack;
+      if(recvPayload(req_socket_, req_recv_, &seq, &ack)) {
+        received(&req_health_, &req_server_, seq, ack, req_recv_);
+        recv(req_recv_);
+      }
+      zmq::poll(&items[0], 1, 0);
+    } while(items[0].revents & ZMQ_POLLIN);
+  } });
+
+  addTimer(send_period_, [this, send_data, fill]() {
+    uint8_t buf[ZmqWire::MAX_SIZE];
+    fill(send_data);
+    size_t size = pack(send_data, ZmqWire::MSG_TELEMETRY, &req_seq_, buf, &req_health_, &req_server_);
+    zmq::message_t send_msg(buf, size);
+    req_socket_.send(send_msg, ZMQ_DONTWAIT);  //dropped while the server is away
+  });
 }
 
-void* ZMQ_CLASS::radioZMQ(ZmqData *send_data)
+/* Server: REQ peers are answered right away, DEALER peers every send_period */
+void ZMQ_CLASS::onReply(ZmqData* send_data, DataFn fill, DataFn recv)
 {
-  if(rad_socket_.connected() && !controlDone_)
-  {
-    zmq::message_t send_msg(DATASIZE);
+  if(!rep_flag_) return;
+
+  readers_.push_back({ rep_socket_, [this, send_data, fill, recv]() {
+    routerRecv(rep_socket_, rep_peers_, &rep_health_, rep_recv_, recv);
+    fill(send_data);
+    routerSend(rep_socket_, rep_peers_, &rep_health_, send_data, true);
+  } });
+
+  addTimer(send_period_, [this, send_data, fill]() {
+    fill(send_data);
+    routerSend(rep_socket_, rep_peers_, &rep_health_, send_data, false);
+  });
+}
+
+/* Beacons go out when the payload changes, and at least every beacon_heartbeat */
+void ZMQ_CLASS::onRadio(ZmqData* send_data, DataFn fill)
+{
+  if(!rad_flag_) return;
+
+  addTimer(send_period_, [this, send_data, fill]() {
+    uint8_t buf[ZmqWire::MAX_SIZE];
+    auto now = std::chrono::steady_clock::now();
+    uint32_t seq = rad_seq_;
+    fill(send_data);
+    size_t size = pack(send_data, beacon_half_ ? ZmqWire::MSG_BEACON : ZmqWire::MSG_TELEMETRY, &seq, buf);
+
+    bool changed = (size != rad_last_.size()) || !ZmqWire::samePayload(buf, rad_last_.data(), size);
+    if(!changed && now - rad_sent_ < std::chrono::milliseconds(beacon_heartbeat_)) {
+      beacon_stats_.suppressed++;
+      return;
+    }
+
+    zmq::message_t send_msg(buf, size);
     send_msg.set_group(rad_group_.c_str());
- 
-    //pub
-    memcpy(send_msg.data(), send_data, DATASIZE);
-    rad_socket_.send(send_msg, 0);
-  }
+    if(rad_socket_.send(send_msg, ZMQ_DONTWAIT)) beacon_stats_.sent++;
+    rad_seq_ = seq;
+    rad_last_.assign(buf, buf + size);
+    rad_sent_ = now;
+  });
 }
 
-void* ZMQ_CLASS::dishZMQ()
+/* Beacons are applied in sequence order, the sender is stale after beacon_timeout */
+void ZMQ_CLASS::onDish(DataFn recv, StaleFn stale)
 {
-  if(dsh_socket_.connected() && !controlDone_)
-  {
-    zmq::message_t recv_msg(DATASIZE);
+  if(!dsh_flag_) return;
+
+  readers_.push_back({ dsh_socket_, [this, recv, stale]() {
+    zmq::message_t recv_msg;
+    while(dsh_socket_.recv(&recv_msg, ZMQ_DONTWAIT)) {
+      ZmqData beacon;
+      uint32_t seq;
+      if(!unpack(recv_msg, &beacon, &seq) || !trackBeacon(seq)) continue;
+      if(beacon_stats_.stale.exchange(false)) {
+        ROS_INFO("[ZMQ] beacon sender back");
+        if(stale) stale(false);
+      }
+      *dsh_recv_ = beacon;
+      recv(dsh_recv_);
+    }
+  } });
+
+  addTimer(send_period_, [this, stale]() {
+    double age = beacon_stats_.ageMs();
+    if(beacon_stats_.stale || age < beacon_timeout_) return;  //stale from the start until the first beacon
+    beacon_stats_.stale = true;
+    beacon_stats_.timeouts++;
+    ROS_WARN("[ZMQ] no beacon for %.0f ms, sender stale", age);
+    if(stale) stale(true);
+  });
+}
 
-    //sub
-    dsh_socket_.recv(&recv_msg, 0);
-    memcpy(dsh_recv_, recv_msg.data(), DATASIZE);
-//    dsh_recv_ = static_cast<ZmqData *>(sub_msg.data());
+/* Sequence check, late and duplicate beacons are dropped, gaps are counted as lost.
+ * After a timeout or a large backward jump (restarted sender) the count resyncs */
+bool ZMQ_CLASS::trackBeacon(uint32_t seq)
+{
+  int32_t gap = (int32_t)(seq - dsh_seq_);
+  bool synced = beacon_stats_.received > 0 && !beacon_stats_.stale;
+  if(synced && gap <= 0 && gap > -BEACON_RESYNC) {
+    beacon_stats_.late++;
+    return false;
   }
+  if(synced && gap > 1) beacon_stats_.lost += gap - 1;
+
+  dsh_seq_ = seq;
+  beacon_stats_.received++;
+  beacon_stats_.last_rx = std::chrono::steady_clock::now().time_since_epoch().count();
+  return true;
 }
 
-//void* ZMQ_CLASS::requestImageZMQ(ImgData *send_data)
-//{
-//  if(req_img_socket_.connected() && !controlDone_)
-//  {
-//    size_t data_size = sizeof(ImgData);
-//    zmq::message_t recv_msg, send_msg(data_size);
-//
-//    //send
-//    memcpy(send_msg.data(), send_data, data_size);
-//    req_img_socket_.send(send_msg);
-//
-//    //recv
-//    req_img_socket_.recv(&recv_msg, 0); //trash
-//  }
-//}
-
-void* ZMQ_CLASS::requestImageZMQ(ImgData *send_data, ImgData *backup_data)
+/* Rear image from the preceding truck, if camera & lidar sensor dual failure.
+ * [header][jpeg], acked on receipt so the leader sends its newest frame during the decode.
+ * The ack carries our stamps, the leader's clock estimate comes back in the next header */
+void ZMQ_CLASS::onImage(ImageFn recv)
 {
-  if(req_img_socket_.connected() && !controlDone_) {
-      size_t data_size = sizeof(ImgData);
-      zmq::message_t recv_msg, send_msg(data_size);
-
-      //send
-      memcpy(send_msg.data(), send_data, data_size);
-      req_img_socket_.send(send_msg);
-
-      bool expect_reply = true;
-      while (expect_reply) {
-          //  Poll socket for a reply, with timeout
-          zmq::pollitem_t items[] = {
-              { req_img_socket_, 0, ZMQ_POLLIN, 0 } };
-          zmq::poll (&items[0], 1, REQUEST_TIMEOUT);
-
-          if (items[0].revents & ZMQ_POLLIN) {
-	    //recv
-            req_img_socket_.recv(&recv_msg, 0); //trash
-            expect_reply = false;
-          }
-          else {
-	    img_socket_change_count_++;
-            //  Old socket will be confused; close it and open a new one
-	    req_img_socket_.close();
-            req_img_socket_ = zmq::socket_t(context_, ZMQ_REQ);
-            req_img_socket_.connect(tcpreq_img_ip_);
-            req_img_socket_.setsockopt(ZMQ_LINGER, 0); 
-
-            //  Send request again, on new socket
-	    zmq::message_t resend_msg(data_size);
-            memcpy(resend_msg.data(), backup_data, data_size);
-            req_img_socket_.send(resend_msg);
-          }
+  if(!rep_img_flag_) return;
+
+  readers_.push_back({ rep_img_socket_, [this, recv]() {
+    zmq::message_t header, jpeg;
+    rep_img_socket_.recv(&header, 0);
+    int64_t rx_us = ClockSync::PeerClock::nowUs();
+    bool complete = header.more() && rep_img_socket_.recv(&jpeg, 0) && !jpeg.more();
+    while(jpeg.more()) rep_img_socket_.recv(&jpeg, 0);  //unknown layout, drained
+
+    ImgData img;
+    ZmqWire::ClockHint clock;
+    bool valid = complete && ZmqWire::decodeImage(header.data(), header.size(), jpeg.size(), &img, &clock);
+
+    uint8_t buf[ZmqWire::IMAGE_ACK_SIZE];
+    ZmqWire::ImageAck receipt;
+    receipt.seq = img.seq;
+    receipt.rx_us = rx_us;
+    receipt.tx_us = ClockSync::PeerClock::nowUs();
+    zmq::message_t ack(buf, ZmqWire::encodeImageAck(img.tar_index, img.src_index, receipt, buf));
+    rep_img_socket_.send(ack);
+
+    if(!valid) {
+      wire_errors_++;
+      return;
+    }
+    if(clock.valid) {
+      int64_t local = ClockSync::PeerClock::toUs(img.startTime) + clock.offset_us;
+      img.startTime.tv_sec = local / 1000000;
+      img.startTime.tv_usec = local % 1000000;
+      img.clock_synced = true;
+    }
+    img.comp_image = static_cast<const u_char*>(jpeg.data());
+    recv(&img);
+  } });
+}
+
+/* Takes every queued message, [id][payload] from DEALER, [id][][payload] from REQ */
+void ZMQ_CLASS::routerRecv(zmq::socket_t& socket, std::vector<ZmqPeer>& peers, LinkHealth* link, ZmqData* recv_data, const DataFn& recv)
+{
+  auto now = std::chrono::steady_clock::now();
+  zmq::pollitem_t items[] = { { socket, 0, ZMQ_POLLIN, 0 } };
+  do {
+    zmq::message_t id, frame;
+    socket.recv(&id, 0);
+    if(id.more()) socket.recv(&frame, 0);
+
+    std::string peer_id(static_cast<char*>(id.data()), id.size());
+    bool lockstep = (frame.size() == 0 && frame.more());
+    bool valid = false;
+    uint32_t seq;
+    ZmqWire::Ack ack;
+    if(lockstep) valid = recvPayload(socket, recv_data, &seq, &ack);
+    else if(!frame.more()) valid = unpack(frame, recv_data, &seq, &ack);
+    else recvPayload(socket, recv_data);  //unknown envelope, drained
+
+    {
+      std::scoped_lock lock(peers_mutex_);
+      auto peer = std::find_if(peers.begin(), peers.end(), [&](const ZmqPeer& p) { return p.id == peer_id; });
+      if(peer == peers.end()) {
+        ROS_INFO("[ZMQ] %s peer connected", lockstep ? "REQ" : "DEALER");
+        peers.push_back(ZmqPeer());
+        peer = peers.end() - 1;
+        peer->id = peer_id;
       }
-  }
+      peer->lockstep = lockstep;
+      peer->pending = true;
+      peer->last_seen = now;
+      if(valid) received(link, &*peer, seq, ack, recv_data);
+    }
+    if(valid) recv(recv_data);
+
+    zmq::poll(&items[0], 1, 0);
+  } while(items[0].revents & ZMQ_POLLIN);
 }
-void* ZMQ_CLASS::replyImageZMQ() //if camera & lidar sensor dual failure
+
+/* One message per live peer, quiet ones are dropped after peer_timeout */
+void ZMQ_CLASS::routerSend(zmq::socket_t& socket, std::vector<ZmqPeer>& peers, LinkHealth* link, ZmqData* send_data, bool lockstep_only)
 {
-  if(rep_img_socket_.connected() && !controlDone_)
+  auto now = std::chrono::steady_clock::now();
+  uint8_t buf[ZmqWire::MAX_SIZE];
+
+  std::scoped_lock lock(peers_mutex_);
+  for(auto peer = peers.begin(); peer != peers.end();)
   {
-    size_t data_size = sizeof(ImgData);
-    zmq::message_t recv_msg(data_size), send_msg;
+    if(now - peer->last_seen > std::chrono::milliseconds(peer_timeout_)) {
+      ROS_WARN("[ZMQ] peer silent for %d ms, dropped", peer_timeout_);
+      peer = peers.erase(peer);
+      continue;
+    }
+    if(peer->lockstep ? peer->pending : !lockstep_only) {
+      size_t size = pack(send_data, ZmqWire::MSG_TELEMETRY, &rep_seq_, buf, link, &*peer);  //per peer, each gets its own ack
+      zmq::message_t id_msg(peer->id.data(), peer->id.size()), send_msg(buf, size);
+      socket.send(id_msg, ZMQ_SNDMORE | ZMQ_DONTWAIT);
+      if(peer->lockstep) {
+        zmq::message_t empty;
+        socket.send(empty, ZMQ_SNDMORE | ZMQ_DONTWAIT);
+      }
+      socket.send(send_msg, ZMQ_DONTWAIT);
+      peer->pending = false;
+    }
+    ++peer;
+  }
+}
 
-    //recv
-    rep_img_socket_.recv(&recv_msg, 0);
-    memcpy(img_recv_, recv_msg.data(), data_size);
+static void releaseJpeg(void*, void* hint)
+{
+  delete static_cast<std::shared_ptr<const std::vector<u_char>>*>(hint);
+}
 
-    //send
-    rep_img_socket_.send(send_msg); //trash
+/* The JPEG frame points at the encoder's buffer, kept alive until zmq has sent it.
+ * Frames encoded while waiting for the ack are never queued, the caller sends the newest next */
+bool ZMQ_CLASS::sendImageZMQ(ImgData *send_data, std::shared_ptr<const std::vector<u_char>> jpeg)
+{
+  if(!req_img_flag_ || controlDone_ || !jpeg || !req_img_health_.up()) return false;
+
+  auto start = std::chrono::steady_clock::now();
+  int64_t t1 = ClockSync::PeerClock::nowUs();
+  uint8_t buf[ZmqWire::IMAGE_HEADER_SIZE];
+  ZmqWire::ClockHint clock;
+  clock.valid = img_clock_.valid();
+  if(clock.valid) clock.offset_us = llround(img_clock_.offsetUs(t1));
+  uint32_t seq = img_seq_++;
+  send_data->size = jpeg->size();
+  size_t size = ZmqWire::encodeImage(*send_data, seq, buf, &clock);
+  zmq::message_t header_msg(buf, size);
+  if(!req_img_socket_.send(header_msg, ZMQ_SNDMORE | ZMQ_DONTWAIT)) return false;
+  auto hold = new std::shared_ptr<const std::vector<u_char>>(jpeg);
+  zmq::message_t jpeg_msg(const_cast<u_char*>(jpeg->data()), jpeg->size(), releaseJpeg, hold);
+  req_img_socket_.send(jpeg_msg, ZMQ_DONTWAIT);
+
+  zmq::pollitem_t items[] = { { req_img_socket_, 0, ZMQ_POLLIN, 0 } };
+  for(int waited = 0; waited < REQUEST_TIMEOUT && !controlDone_; waited += IMAGE_POLL_SLICE) {
+    zmq::poll(&items[0], 1, IMAGE_POLL_SLICE);
+    if(items[0].revents & ZMQ_POLLIN) {
+      zmq::message_t ack;
+      req_img_socket_.recv(&ack, 0);
+      int64_t t4 = ClockSync::PeerClock::nowUs();
+      rttSample(&req_img_health_, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+      ZmqWire::ImageAck receipt;
+      if(ZmqWire::decodeImageAck(ack.data(), ack.size(), &receipt) && receipt.seq == seq) {
+        img_clock_.addExchange(t1, receipt.rx_us, receipt.tx_us, t4);
+        req_img_health_.clock = img_clock_.offsetUs(t4) / 1000.0;
+        req_img_health_.skew = img_clock_.skewPpm();
+      }
+      return true;
+    }
+    if(!req_img_health_.up()) break;  //peer gone, no point waiting out the timeout
   }
+  req_img_health_.timeouts++;
+  return false;
 }
@@ -0,0 +1,265 @@
+#include "zmq_wire/zmq_wire.hpp"
+
+namespace ZmqWire {
+
+/* Byte cursor, little-endian regardless of the host */
+struct Writer {
+	uint8_t* p;
+	void u8(uint8_t v) { *p++ = v; }
+	void u16(uint16_t v) { u8(v & 0xff); u8(v >> 8); }
+	void u32(uint32_t v) { u16(v & 0xffff); u16(v >> 16); }
+	void i64(int64_t v) { u32((uint64_t)v & 0xffffffff); u32((uint64_t)v >> 32); }
+	void f32(float v) { uint32_t u; memcpy(&u, &v, 4); u32(u); }
+};
+
+struct Reader {
+	const uint8_t* p;
+	uint8_t u8() { return *p++; }
+	uint16_t u16() { uint16_t lo = u8(); return lo | (u8() << 8); }
+	uint32_t u32() { uint32_t lo = u16(); return lo | ((uint32_t)u16() << 16); }
+	int64_t i64() { uint64_t lo = u32(); return (int64_t)(lo | ((uint64_t)u32() << 32)); }
+	float f32() { uint32_t u = u32(); float v; memcpy(&v, &u, 4); return v; }
+};
+
+static int64_t toUs(const struct timeval& tv) {
+	return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static struct timeval fromUs(int64_t us) {
+	struct timeval tv;
+	tv.tv_sec = us / 1000000;
+	tv.tv_usec = us % 1000000;
+	return tv;
+}
+
+size_t encode(const ZmqData& data, MsgType type, uint32_t seq, uint8_t* buf, const Ack* ack) {
+	const float floats[FLOATS] = {
+		data.ref_vel, data.cur_vel, data.cur_dist, data.cur_angle,
+		data.tar_vel, data.tar_dist, data.est_vel, data.preceding_truck_vel,
+		data.coef[0].a, data.coef[0].b, data.coef[0].c,
+		data.coef[1].a, data.coef[1].b, data.coef[1].c,
+		data.coef[2].a, data.coef[2].b, data.coef[2].c
+	};
+	uint16_t flags = (data.fi_encoder ? FLAG_FI_ENCODER : 0) | (data.fi_camera ? FLAG_FI_CAMERA : 0)
+		| (data.fi_lidar ? FLAG_FI_LIDAR : 0) | (data.alpha ? FLAG_ALPHA : 0)
+		| (data.beta ? FLAG_BETA : 0) | (data.gamma ? FLAG_GAMMA : 0)
+		| (data.send_rear_camera_image ? FLAG_REAR_IMAGE : 0)
+		| ((ack && ack->valid) ? FLAG_ACK : 0);
+
+	Writer w{buf};
+	w.u8(WIRE_MAGIC);
+	w.u8(WIRE_VERSION);
+	w.u8(type);
+	w.u8(data.src_index);
+	w.u8(data.tar_index);
+	w.u8(((data.lrc_mode & 0x03) << 6) | ((data.crc_mode & 0x03) << 4) | (data.qos_level & 0x0f));
+	w.u16(flags);
+	w.u32(seq);
+	w.u32((ack && ack->valid) ? ack->seq : 0);
+	w.u32((ack && ack->valid) ? ack->delay_us : 0);
+	for (size_t i = 0; i < FLOATS; i++) {
+		if (type == MSG_BEACON) w.u16(toHalf(floats[i]));
+		else w.f32(floats[i]);
+	}
+	w.i64(toUs(data.image_stamp));
+	w.i64(toUs(data.send_stamp));
+	w.u16(crc16(buf, w.p - buf));
+	return w.p - buf;
+}
+
+bool decode(const void* buf, size_t size, ZmqData* data, uint32_t* seq, Ack* ack) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(buf);
+	if (size < HEADER_SIZE || bytes[0] != WIRE_MAGIC || bytes[1] != WIRE_VERSION) return false;
+
+	MsgType type = static_cast<MsgType>(bytes[2]);
+	if (!((type == MSG_TELEMETRY && size == TELEMETRY_SIZE) || (type == MSG_BEACON && size == BEACON_SIZE))) return false;
+
+	Reader crc{bytes + size - CRC_SIZE};
+	if (crc.u16() != crc16(bytes, size - CRC_SIZE)) return false;
+
+	Reader r{bytes + 3};
+	ZmqData out;
+	out.src_index = r.u8();
+	out.tar_index = r.u8();
+	uint8_t modes = r.u8();
+	out.lrc_mode = modes >> 6;
+	out.crc_mode = (modes >> 4) & 0x03;
+	out.qos_level = modes & 0x0f;
+	uint16_t flags = r.u16();
+	out.fi_encoder = flags & FLAG_FI_ENCODER;
+	out.fi_camera = flags & FLAG_FI_CAMERA;
+	out.fi_lidar = flags & FLAG_FI_LIDAR;
+	out.alpha = flags & FLAG_ALPHA;
+	out.beta = flags & FLAG_BETA;
+	out.gamma = flags & FLAG_GAMMA;
+	out.send_rear_camera_image = flags & FLAG_REAR_IMAGE;
+	uint32_t packet_seq = r.u32();
+	Ack packet_ack;
+	packet_ack.seq = r.u32();
+	packet_ack.delay_us = r.u32();
+	packet_ack.valid = flags & FLAG_ACK;
+
+	float floats[FLOATS];
+	for (size_t i = 0; i < FLOATS; i++) {
+		floats[i] = (type == MSG_BEACON) ? fromHalf(r.u16()) : r.f32();
+	}
+	out.ref_vel = floats[0];
+	out.cur_vel = floats[1];
+	out.cur_dist = floats[2];
+	out.cur_angle = floats[3];
+	out.tar_vel = floats[4];
+	out.tar_dist = floats[5];
+	out.est_vel = floats[6];
+	out.preceding_truck_vel = floats[7];
+	for (int i = 0; i < 3; i++) {
+		out.coef[i].a = floats[8 + i * 3];
+		out.coef[i].b = floats[9 + i * 3];
+		out.coef[i].c = floats[10 + i * 3];
+	}
+	out.image_stamp = fromUs(r.i64());
+	out.send_stamp = fromUs(r.i64());
+
+	*data = out;
+	if (seq) *seq = packet_seq;
+	if (ack) *ack = packet_ack;
+	return true;
+}
+
+size_t encodeImage(const ImgData& img, uint32_t seq, uint8_t* buf, const ClockHint* clock) {
+	bool has_clock = clock && clock->valid;
+	Writer w{buf};
+	w.u8(WIRE_MAGIC);
+	w.u8(WIRE_VERSION);
+	w.u8(MSG_IMAGE);
+	w.u8(img.src_index);
+	w.u8(img.tar_index);
+	w.u8(0);
+	w.u16(has_clock ? FLAG_CLOCK : 0);
+	w.u32(seq);
+	w.u32(img.size);
+	w.i64(toUs(img.startTime));
+	w.i64(has_clock ? clock->offset_us : 0);
+	w.u16(crc16(buf, w.p - buf));
+	return w.p - buf;
+}
+
+bool decodeImage(const void* buf, size_t size, size_t payload_size, ImgData* img, ClockHint* clock) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(buf);
+	if (size != IMAGE_HEADER_SIZE || bytes[0] != WIRE_MAGIC || bytes[1] != WIRE_VERSION || bytes[2] != MSG_IMAGE) return false;
+
+	Reader crc{bytes + size - CRC_SIZE};
+	if (crc.u16() != crc16(bytes, size - CRC_SIZE)) return false;
+
+	Reader r{bytes + 3};
+	ImgData out;
+	out.src_index = r.u8();
+	out.tar_index = r.u8();
+	r.u8();
+	uint16_t flags = r.u16();
+	out.seq = r.u32();
+	out.size = r.u32();
+	out.startTime = fromUs(r.i64());
+	ClockHint hint;
+	hint.offset_us = r.i64();
+	hint.valid = flags & FLAG_CLOCK;
+	if (out.size != payload_size) return false;
+
+	*img = out;
+	if (clock) *clock = hint;
+	return true;
+}
+
+size_t encodeImageAck(uint8_t src_index, uint8_t tar_index, const ImageAck& ack, uint8_t* buf) {
+	Writer w{buf};
+	w.u8(WIRE_MAGIC);
+	w.u8(WIRE_VERSION);
+	w.u8(MSG_IMAGE_ACK);
+	w.u8(src_index);
+	w.u8(tar_index);
+	w.u8(0);
+	w.u16(0);
+	w.u32(ack.seq);
+	w.i64(ack.rx_us);
+	w.i64(ack.tx_us);
+	w.u16(crc16(buf, w.p - buf));
+	return w.p - buf;
+}
+
+bool decodeImageAck(const void* buf, size_t size, ImageAck* ack) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(buf);
+	if (size != IMAGE_ACK_SIZE || bytes[0] != WIRE_MAGIC || bytes[1] != WIRE_VERSION || bytes[2] != MSG_IMAGE_ACK) return false;
+
+	Reader crc{bytes + size - CRC_SIZE};
+	if (crc.u16() != crc16(bytes, size - CRC_SIZE)) return false;
+
+	Reader r{bytes + 8};
+	ack->seq = r.u32();
+	ack->rx_us = r.i64();
+	ack->tx_us = r.i64();
+	return true;
+}
+
+bool samePayload(const uint8_t* a, const uint8_t* b, size_t size) {
+	if (size < HEADER_SIZE + STAMPS_SIZE + CRC_SIZE) return false;
+	const size_t seq_at = 8, stamp_at = size - CRC_SIZE - 8;
+	return memcmp(a, b, seq_at) == 0 && memcmp(a + HEADER_SIZE, b + HEADER_SIZE, stamp_at - HEADER_SIZE) == 0;
+}
+
+uint16_t crc16(const uint8_t* buf, size_t size) {
+	uint16_t crc = 0xffff;
+	for (size_t i = 0; i < size; i++) {
+		crc ^= (uint16_t)buf[i] << 8;
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+/* IEEE 754 binary16, round to nearest even, saturates to +-65504 */
+uint16_t toHalf(float value) {
+	uint32_t f;
+	memcpy(&f, &value, 4);
+	uint16_t sign = (f >> 16) & 0x8000;
+	int32_t exp = ((f >> 23) & 0xff) - 127 + 15;
+	uint32_t mant = f & 0x7fffff;
+
+	if (((f >> 23) & 0xff) == 0xff) return sign | 0x7c00 | (mant ? 0x200 : 0);  // inf / nan
+	if (exp >= 31) return sign | 0x7bff;
+	if (exp <= 0) {
+		if (exp < -10) return sign;
+		mant |= 0x800000;
+		int shift = 14 - exp;
+		uint32_t half = mant >> shift;
+		uint32_t rest = mant & ((1u << shift) - 1);
+		uint32_t mid = 1u << (shift - 1);
+		if (rest > mid || (rest == mid && (half & 1))) half++;
+		return sign | half;
+	}
+	uint32_t half = (exp << 10) | (mant >> 13);
+	uint32_t rest = mant & 0x1fff;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;
+	if (half >= 0x7c00) half = 0x7bff;
+	return sign | half;
+}
+
+float fromHalf(uint16_t half) {
+	uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+	uint32_t exp = (half >> 10) & 0x1f;
+	uint32_t mant = half & 0x3ff;
+	uint32_t f;
+
+	if (exp == 0x1f) f = sign | 0x7f800000 | (mant << 13);
+	else if (exp != 0) f = sign | ((exp - 15 + 127) << 23) | (mant << 13);
+	else if (mant == 0) f = sign;
+	else {
+		exp = 127 - 15 + 1;
+		while (!(mant & 0x400)) { mant <<= 1; exp--; }
+		f = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+	}
+	float value;
+	memcpy(&value, &f, 4);
+	return value;
+}
+
+}
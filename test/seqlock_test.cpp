@@ -0,0 +1,112 @@
+/*
+ * seqlock_test.cpp
+ *
+ * Several writers publish snapshots whose fields all hold the same counter,
+ * readers load() in a tight loop. A snapshot with two different fields was
+ * torn by a racing write.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "seqlock/seqlock.hpp"
+
+using scale_truck_control::Seqlock;
+
+namespace {
+
+const int WRITERS = 4;
+const int READERS = 4;
+const uint32_t WRITES = 200000;  // per writer
+
+typedef struct Snapshot{
+  uint32_t counter[13];  // odd word count, no field lands on a cache line boundary by luck
+  double value;
+  uint8_t tail;
+}Snapshot;
+
+Snapshot makeSnapshot(uint32_t counter){
+  Snapshot snapshot;
+  for(uint32_t& field : snapshot.counter) field = counter;
+  snapshot.value = counter;
+  snapshot.tail = counter & 0xff;
+  return snapshot;
+}
+
+bool consistent(const Snapshot& snapshot){
+  for(uint32_t field : snapshot.counter){
+    if(field != snapshot.counter[0]) return false;
+  }
+  return snapshot.value == snapshot.counter[0] && snapshot.tail == (snapshot.counter[0] & 0xff);
+}
+
+/* Readers until every writer is done, returns loads and torn snapshots seen */
+void readUntil(const Seqlock<Snapshot>& lock, const std::atomic<int>& writing,
+               std::atomic<uint64_t>* loads, std::atomic<uint64_t>* torn){
+  uint64_t local_loads = 0, local_torn = 0;
+  while(writing > 0){
+    if(!consistent(lock.load())) local_torn++;
+    local_loads++;
+  }
+  *loads += local_loads;
+  *torn += local_torn;
+}
+
+}  // namespace
+
+TEST(Seqlock, StoreUnderContention){
+  Seqlock<Snapshot> lock(makeSnapshot(0));
+  std::atomic<int> writing{WRITERS};
+  std::atomic<uint64_t> loads{0}, torn{0};
+
+  std::vector<std::thread> threads;
+  for(int i = 0; i < READERS; i++){
+    threads.emplace_back(readUntil, std::cref(lock), std::cref(writing), &loads, &torn);
+  }
+  for(int i = 0; i < WRITERS; i++){
+    threads.emplace_back([&lock, &writing, i](){
+      for(uint32_t n = 1; n <= WRITES; n++) lock.store(makeSnapshot(n * WRITERS + i));
+      writing--;
+    });
+  }
+  for(std::thread& thread : threads) thread.join();
+
+  EXPECT_GT(loads.load(), 0u);
+  EXPECT_EQ(torn.load(), 0u);
+  EXPECT_TRUE(consistent(lock.load()));
+  EXPECT_EQ(lock.sequence(), 1 + WRITERS * WRITES);  // constructor write included
+}
+
+TEST(Seqlock, UpdateUnderContention){
+  Seqlock<Snapshot> lock(makeSnapshot(0));
+  std::atomic<int> writing{WRITERS};
+  std::atomic<uint64_t> loads{0}, torn{0};
+
+  std::vector<std::thread> threads;
+  for(int i = 0; i < READERS; i++){
+    threads.emplace_back(readUntil, std::cref(lock), std::cref(writing), &loads, &torn);
+  }
+  for(int i = 0; i < WRITERS; i++){
+    threads.emplace_back([&lock, &writing](){
+      for(uint32_t n = 0; n < WRITES; n++){
+        lock.update([](Snapshot& snapshot){ snapshot = makeSnapshot(snapshot.counter[0] + 1); });
+      }
+      writing--;
+    });
+  }
+  for(std::thread& thread : threads) thread.join();
+
+  EXPECT_GT(loads.load(), 0u);
+  EXPECT_EQ(torn.load(), 0u);
+  Snapshot last = lock.load();
+  EXPECT_TRUE(consistent(last));
+  EXPECT_EQ(last.counter[0], WRITERS * WRITES);  // no increment lost between writers
+}
+
+int main(int argc, char** argv){
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}